@@ -0,0 +1,74 @@
+/*****************************************************************************
+ * Project: CMS detector at the CERN
+ *
+ * Package: ElectroWeakAnalysis/VPlusJets
+ *
+ *
+ * Authors:
+ *   A. Marini, K. Kousouris,  K. Theofilatos
+ *
+ * Description:
+ *   Eta-phi grid index of a collection of objects, built once per event,
+ *   answering deltaR cone queries in time proportional to the number of
+ *   objects in the cells around the cone instead of the whole collection.
+ * History:
+ *
+ *****************************************************************************/
+
+#ifndef ElectroWeakAnalysis_VPlusJets_EtaPhiGrid_h
+#define ElectroWeakAnalysis_VPlusJets_EtaPhiGrid_h
+
+#include <vector>
+
+namespace ewk {
+
+  class EtaPhiGrid {
+  public:
+
+    /// cells of cellSize x cellSize; |eta| beyond etaMax goes to the edge cells
+    EtaPhiGrid(double cellSize = 0.3, double etaMax = 5.0);
+    ~EtaPhiGrid() {};
+
+    /// index every element of a collection with eta() and phi();
+    /// the element positions in the collection are the indices returned
+    template <typename C> void fill(const C& collection) {
+      etas_.clear();
+      phis_.clear();
+      for (typename C::const_iterator it = collection.begin(); it != collection.end(); ++it) {
+        etas_.push_back(it->eta());
+        phis_.push_back(it->phi());
+      }
+      build();
+    }
+    /// same, from explicit coordinates
+    void fill(const std::vector<double>& etas, const std::vector<double>& phis);
+
+    /// indices of the objects with deltaR < R, in increasing order
+    void coneIndices(double eta, double phi, double R, std::vector<unsigned int>& indices) const;
+    /// whether any object has deltaR < R
+    bool anyInCone(double eta, double phi, double R) const;
+
+    unsigned int size() const { return etas_.size(); }
+
+  private:
+    void build();
+    int etaBin(double eta) const;
+    int phiBin(double phi) const;
+    /// visits the candidate cells; stops early when the visitor returns true
+    template <typename V> bool visit(double eta, double phi, double R, V& visitor) const;
+
+    double cellSize_;
+    double etaMax_;
+    int nEta_;
+    int nPhi_;
+
+    std::vector<double> etas_;
+    std::vector<double> phis_;
+    /// objects of cell c are cellItems_[cellStart_[c] .. cellStart_[c+1]-1]
+    std::vector<unsigned int> cellStart_;
+    std::vector<unsigned int> cellItems_;
+  };
+
+}
+
+#endif
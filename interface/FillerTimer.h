@@ -0,0 +1,97 @@
+/*****************************************************************************
+ * Project: CMS detector at the CERN
+ *
+ * Package: ElectroWeakAnalysis/VPlusJets
+ *
+ *
+ * Authors:
+ *
+ *   Kalanand Mishra, Fermilab - kalanand@fnal.gov
+ *
+ * Description:
+ *   Opt-in per-step cost accounting for the tree fillers: wall time and
+ *   CPU time of named steps (a whole filler, or a part of one), summed
+ *   per event, and the number of heap allocations when the allocation
+ *   counter of test/Benchmarks/allocationCounter.c is preloaded.
+ *   The per-event values are kept in logarithmic
+ *   histograms, so the memory use does not grow with the number of events,
+ *   and summarised at the end of the job as percentiles.
+ *   When disabled, start/stop/endEvent do nothing.
+ * History:
+ *
+ *
+ * Copyright (C) 2013 FNAL
+ *****************************************************************************/
+
+#ifndef ElectroWeakAnalysis_VPlusJets_FillerTimer_h
+#define ElectroWeakAnalysis_VPlusJets_FillerTimer_h
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "TTree.h"
+
+namespace ewk {
+
+  class FillerTimer {
+  public:
+
+    explicit FillerTimer(bool enabled = false);
+    ~FillerTimer() {};
+
+    bool enabled() const { return enabled_; }
+    /// enabled, and the allocation counter is preloaded
+    bool countsAllocations() const { return countAllocations_; }
+
+    /// register a step, e.g. "GroomedJet_AK5/nsubjettiness"; returns its id
+    unsigned int addStep(const std::string& name);
+
+    /// accumulate the cost between start and stop into the current event;
+    /// a step may be started and stopped several times per event
+    void start(unsigned int step);
+    void stop(unsigned int step);
+
+    /// To be called once per event, after all fillers
+    void endEvent();
+
+    /// one entry per step: number of events, mean and 50/90/99% percentiles
+    /// of the per-event wall and CPU time [ms] and allocations (-1 if not counted)
+    void writeSummary(TTree* tree) const;
+    void printSummary(std::ostream& out) const;
+
+  private:
+
+    /// logarithmic histogram of per-event values over nine decades,
+    /// 1 us ... 1000 s for the times, 1 ... 1e9 for the allocations
+    struct Distribution {
+      explicit Distribution(double minValue);
+      void add(double value);
+      double quantile(double q) const;
+      std::vector<unsigned long> counts;
+      unsigned long n;
+      double sum;
+      double min;
+    };
+
+    struct Step {
+      std::string name;
+      /// running measurement, valid between start and stop
+      double wallStart, cpuStart;
+      unsigned long allocStart;
+      /// sums over the current event
+      double wall, cpu;
+      unsigned long allocs;
+      bool touched;
+      Distribution wallMs, cpuMs, allocations;
+      Step();
+    };
+
+    bool enabled_;
+    bool countAllocations_;
+    std::vector<Step> steps_;
+  };
+
+}
+
+#endif
@@ -0,0 +1,82 @@
+/*****************************************************************************
+ * Project: CMS detector at the CERN
+ *
+ * Package: ElectroWeakAnalysis/VPlusJets
+ *
+ *
+ * Authors:
+ *
+ *   Kalanand Mishra, Fermilab - kalanand@fnal.gov
+ *
+ * Description:
+ *   Per-event index of a reco::GenParticleCollection, built in one pass:
+ *   the status-3 particles in record order, bucketed by |pdgId|, and the
+ *   mother/daughter links of every particle as collection indices.
+ * History:
+ *   
+ *
+ * Copyright (C) 2010 FNAL 
+ *****************************************************************************/
+
+#ifndef ElectroWeakAnalysis_VPlusJets_GenParticleIndex_h
+#define ElectroWeakAnalysis_VPlusJets_GenParticleIndex_h
+
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/HepMCCandidate/interface/GenParticle.h"
+#include "DataFormats/HepMCCandidate/interface/GenParticleFwd.h"
+
+
+namespace ewk {
+
+  class GenParticleIndex {
+  public:
+
+    GenParticleIndex();
+    ~GenParticleIndex() {};
+
+    /// To be called once per event, before any of the queries
+    void fill(const edm::Handle<reco::GenParticleCollection>& genParticles);
+
+    const reco::GenParticle& at(int i) const { return (*genParticles_)[i]; }
+    size_t size() const { return mothers_.size(); }
+
+    /// indices of the particles with |status| == 3, in record order
+    const std::vector<int>& status3() const { return status3_; }
+    /// the same, restricted to one |pdgId|
+    const std::vector<int>& status3(int absPdgId) const;
+    /// number of partons (|pdgId| <= 5 or gluons) with status == 3
+    int nStatus3Partons() const { return nStatus3Partons_; }
+
+    /// collection indices of the mothers / daughters of particle i
+    std::pair<const int*, const int*> mothers(int i) const { return range(mothers_, motherKeys_, i); }
+    std::pair<const int*, const int*> daughters(int i) const { return range(daughters_, daughterKeys_, i); }
+
+    /// status-3 partons that share a mother with particle i, in record order
+    void status3PartonSiblings(int i, std::vector<int>& siblings) const;
+
+    static bool isParton(int pdgId) { return abs(pdgId) <= 5 || pdgId == 21; }
+
+  private:
+    std::pair<const int*, const int*> range(const std::vector<int>& offsets, const std::vector<int>& keys, int i) const;
+
+    static const int MAX_BUCKET_PDGID = 100;
+
+    edm::Handle<reco::GenParticleCollection> genParticles_;
+    std::vector<int> status3_;
+    std::vector< std::vector<int> > byPdgId_;
+    std::vector<int> empty_;
+    int nStatus3Partons_;
+
+    /// offsets into the flat key arrays, size() + 1 entries
+    std::vector<int> mothers_;
+    std::vector<int> motherKeys_;
+    std::vector<int> daughters_;
+    std::vector<int> daughterKeys_;
+  };
+
+}
+
+#endif
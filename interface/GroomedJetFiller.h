@@ -26,11 +26,14 @@
 #include <iostream>
 #include <map>
 #include <fstream>
+#include <exception>
 
 // user include files
 #include "FWCore/Framework/interface/Frameworkfwd.h"
 #include "FWCore/Framework/interface/EDAnalyzer.h"
 #include "FWCore/Framework/interface/Event.h" 
+#include "ElectroWeakAnalysis/VPlusJets/interface/GroomedJetParticleCache.h"
+#include "ElectroWeakAnalysis/VPlusJets/interface/FillerTimer.h"
 
 #include "TFile.h"
 #include "TTree.h"
@@ -43,11 +46,21 @@
 
 #include <fastjet/JetDefinition.hh>
 #include <fastjet/PseudoJet.hh>
+#include <fastjet/AreaDefinition.hh>
+#include <fastjet/Selector.hh>
 
 #include <stdlib.h>
 #include <math.h>
 #include "TMatrixD.h"
 #include "TMatrixDSym.h"
+namespace fastjet
+{
+    class Transformer;
+    class NsubjettinessBatch;
+    class GeneralizedEnergyCorrelatorRatio;
+}
+class QjetsPlugin;
+
 //
 // class decleration
 //
@@ -63,15 +76,25 @@ namespace ewk
 		       const edm::ParameterSet& iConfig, bool isGen = 0);
 
       /// default constructor
-      GroomedJetFiller() {};
+      GroomedJetFiller() : timer_(0), mNsubKT(0), mECFRatio(0) {};
 
 
-    /// Destructor, does nothing 
+    /// Destructor, deletes the groomers
       //~GroomedJetFiller(){  if(jec_) delete jec_;  if(jecUnc_) delete jecUnc_; };
-      ~GroomedJetFiller(){ };
+      ~GroomedJetFiller();
          
-    /// To be called once per event to fill the values for groomed jets
-    void fill(const edm::Event& iEvent);        
+    /// Register the input collection of this filler with the shared cache
+    void registerInputs(GroomedJetParticleCache& particleCache) const;
+
+    /// To be called once per event to fill the values for groomed jets,
+    /// after the particle cache has been filled for this event
+    void fill(const edm::Event& iEvent, const GroomedJetParticleCache& particleCache);        
+
+    /// branch prefix of this filler, e.g. "GenGroomedJet_CA8"
+    std::string name() const { return lableGen + "GroomedJet_" + jetLabel_; }
+
+    /// Register the sub-steps of fill (clustering, grooming, ...) with a timer
+    void setTimer(FillerTimer* timer);
 
     static const int NUM_JET_MAX = 6;
 
@@ -83,12 +106,62 @@ namespace ewk
     void SetBranch( int* x, std::string name);
     void SetBranchSingle( float* x, std::string name);
     void SetBranchSingle( int* x, std::string name);
+    /// declares the branch only if it matches one of GroomedJet_activeBranches
+    void SetBranchLeaf( void* x, std::string name, std::string leaf );
+    bool isActive( const std::string& name ) const;
     double getJEC(double curJetEta, double curJetPt, double curJetE, double curJetArea); 
     TLorentzVector getCorrectedJet(fastjet::PseudoJet& jet, double inArea);
-    void computeCore( std::vector<fastjet::PseudoJet> constits, double Rval, float &m_core, float &pt_core );
-    void computePlanarflow(std::vector<fastjet::PseudoJet> constits,double Rval,fastjet::PseudoJet jet,std::string mJetAlgo,float &planarflow);
-        float computeJetCharge( std::vector<fastjet::PseudoJet> constits, std::vector<float> pdgIds, float PTjet, float kappa );        
+    /// leading C/A jet (and its constituents) for each of the ascending radii, from one clustering
+    void computeRadiusScan( const std::vector<fastjet::PseudoJet>& constits, const std::vector<double>& radii,
+                            std::vector<fastjet::PseudoJet>& leadingJets, std::vector< std::vector<fastjet::PseudoJet> >* leadingConstits );
+    void computePlanarflow(const std::vector<fastjet::PseudoJet>& subconstits,const fastjet::PseudoJet& jet,float &planarflow);
+        /// jet charge for several kappas in one pass over the constituents
+        void computeJetCharge( const std::vector<fastjet::PseudoJet>& constits, const std::vector<float>& pdgIds, float PTjet, 
+                               const float* kappas, float* charges, unsigned int nKappas );        
         float getPdgIdCharge( float fid );        
+        /// all Qjets trials for the given constituents, each with its own seed,
+        /// spread over GroomedJet_QJetsNThreads threads
+        void computeQjetTrials( const std::vector<fastjet::PseudoJet>& constits, const edm::EventID& eventId );
+        /// Qjets trials first, first+stride, ... on the plugin of one thread
+        void computeQjetTrialRange( const std::vector<fastjet::PseudoJet>* inputs, const edm::EventID* eventId,
+                                    unsigned int first, unsigned int stride, std::exception_ptr* error );
+        unsigned int qjetsSeed( const edm::EventID& eventId, unsigned int trial ) const;
+
+        /// timed sub-steps of fill, no-ops unless setTimer was called
+        enum TimedStep { tClustering = 0, tGrooming, tNsubjettiness, tCores, tQjets, tChargeECF, nTimedSteps };
+        void startTimer( TimedStep step ) { if (timer_) timer_->start(timerSteps_[step]); }
+        void stopTimer( TimedStep step ) { if (timer_) timer_->stop(timerSteps_[step]); }
+        FillerTimer* timer_;
+        unsigned int timerSteps_[nTimedSteps];
+
+        /// optional calculations of fill, each done only if one of the
+        /// branches it fills is active
+        enum Computation { cTrimming = 0, cFiltering, cPruning, cPrunedNsubjettiness, cPrunedSubjets,
+                           cNsubjettiness, cNsubjettinessExkT, cCores, cPlanarflow, cQJets, cJetCharge,
+                           cGeneralizedECF, nComputations };
+        void setComputations();
+        /// glob patterns of the branches to declare, "*" by default
+        std::vector<std::string> mActiveBranches;
+        bool mCompute[nComputations];
+
+        /// clustering, grooming and substructure tools, set up once in the constructor
+        fastjet::JetDefinition mJetDef;
+        fastjet::AreaDefinition mAreaDef;
+        fastjet::JetDefinition mECFJetDef;
+        fastjet::JetDefinition mPrunedSubjetDef;           // single-clustering mode only
+        fastjet::Selector mNoGhosts;
+        std::vector<fastjet::Transformer*> mTransformers;   // trimmer, filter, pruner
+        fastjet::NsubjettinessBatch* mNsubKT;
+        fastjet::GeneralizedEnergyCorrelatorRatio* mECFRatio;
+        std::vector<QjetsPlugin*> mQjetPlugins;            // one per Qjets thread
+        std::vector<double> mScanRadii;                    // cores and planar flow radii
+
+        /// per-event scratch space, kept so that it keeps its capacity
+        std::vector<fastjet::PseudoJet> mOutJets, mOutJetsBasic, mBasicConstituents, mConstits, mScanJets, mQjetConstits;
+        std::vector<fastjet::PseudoJet> mQjetInputs;       // structure-free, shared by the Qjets threads
+        std::vector< std::vector<fastjet::PseudoJet> > mScanConstits;
+        std::vector<float> mPdgIds;
+        std::vector<double> mTausKT, mTausOnepass;
 
     TTree* tree_;
     bool runningOverMC_;
@@ -112,10 +185,16 @@ namespace ewk
         bool mDoQJets; 
         int mQJetsPreclustering;
         int mQJetsN;
+        int mQJetsNThreads;
         double mNsubjettinessKappa;
         bool mSaveConstituents;
+        bool mSingleClustering;
 
     private:
+
+    /// owns the groomers and the Qjets plugins: not copyable
+    GroomedJetFiller(const GroomedJetFiller&);
+    GroomedJetFiller& operator=(const GroomedJetFiller&);
     
     // ----------member data ---------------------------
     // names of modules, producing object collections    
@@ -212,7 +291,6 @@ namespace ewk
         std::vector<int> neutrals;
         std::vector<int> positives;
         std::vector<int> negatives;        
-        std::vector<float>  charge_handle_Gen;
 
     
     double rhoVal_;
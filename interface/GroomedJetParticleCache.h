@@ -0,0 +1,82 @@
+/*****************************************************************************
+ * Project: CMS detector at the CERN
+ *
+ * Package: ElectroWeakAnalysis/VPlusJets
+ *
+ *
+ * Authors:
+ *   Nhan V Tran, Fermilab - kalanand@fnal.gov
+ *   Kalanand Mishra, Fermilab - kalanand@fnal.gov
+ *
+ * Description:
+ *   Per-event cache of the fastjet inputs of the GroomedJetFillers.
+ *   Every input collection (PF candidates, pfInputs px/py/pz/energy/pdgId
+ *   vectors, genParticlesForJets) is converted to PseudoJets once per
+ *   event, together with rho and the number of good primary vertices,
+ *   and shared by all the fillers reading the same collection.
+ * History:
+ *
+ *
+ * Copyright (C) 2012 FNAL
+ *****************************************************************************/
+
+#ifndef GroomedJetParticleCache_h
+#define GroomedJetParticleCache_h
+
+// system include files
+#include <string>
+#include <vector>
+#include <map>
+
+// user include files
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+#include <fastjet/PseudoJet.hh>
+
+namespace ewk
+{
+  class GroomedJetParticleCache {
+  public:
+
+    /// how the input collection is stored in the event
+    enum InputType { PFCandidates = 0, PFInputs, GenParticles };
+
+    /// fastjet inputs built from one collection
+    struct Particles {
+      /// user_index() of each particle is its position in this vector
+      std::vector<fastjet::PseudoJet> particles;
+      /// pdgId of each particle (PF and gen inputs)
+      std::vector<float> pdgIds;
+      /// charge of each particle (gen inputs only)
+      std::vector<float> charges;
+    };
+
+    GroomedJetParticleCache(const edm::ParameterSet& iConfig);
+    ~GroomedJetParticleCache() {};
+
+    /// register an input collection; repeated labels are converted only once
+    void addInput(const std::string& label, InputType type);
+
+    /// To be called once per event, before any of the fillers
+    void fill(const edm::Event& iEvent);
+
+    /// particles of a registered collection for the current event
+    const Particles& particles(const std::string& label) const;
+
+    double rho() const { return rhoVal_; }
+    double nPV() const { return nPV_; }
+
+  private:
+    std::map<std::string, InputType> inputs_;
+    std::map<std::string, Particles> particles_;
+
+    std::string JetsFor_rho;
+    edm::InputTag mPrimaryVertex;
+
+    double rhoVal_;
+    double nPV_;
+  };
+}
+#endif
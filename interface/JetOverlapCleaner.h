@@ -0,0 +1,84 @@
+/*****************************************************************************
+ * Project: CMS detector at the CERN
+ *
+ * Package: ElectroWeakAnalysis/VPlusJets
+ *
+ *
+ * Authors:
+ *   A. Marini, K. Kousouris,  K. Theofilatos
+ *
+ * Description:
+ *   Jet-object overlap removal shared by the jet cleaners: flags the jets
+ *   with any object of the given collections closer than deltaRMin.
+ *   Jet and object coordinates are gathered once per event into plain
+ *   arrays; small collections are compared pairwise with an early
+ *   rejection on delta eta, large ones through an EtaPhiGrid.
+ * History:
+ *
+ *****************************************************************************/
+
+#ifndef ElectroWeakAnalysis_VPlusJets_JetOverlapCleaner_h
+#define ElectroWeakAnalysis_VPlusJets_JetOverlapCleaner_h
+
+#include <vector>
+
+#include "ElectroWeakAnalysis/VPlusJets/interface/EtaPhiGrid.h"
+
+namespace ewk {
+
+  class JetOverlapCleaner {
+  public:
+
+    /// jet x object counts up to maxPairsForPairwise are compared pairwise,
+    /// larger ones through the grid
+    JetOverlapCleaner(double deltaRMin, unsigned int maxPairsForPairwise = 5000);
+    ~JetOverlapCleaner() {};
+
+    /// start a new event: every jet of the collection is clean
+    template <typename C> void setJets(const C& jets) {
+      jetEtas_.clear();
+      jetPhis_.clear();
+      for (typename C::const_iterator it = jets.begin(); it != jets.end(); ++it) {
+        jetEtas_.push_back(it->eta());
+        jetPhis_.push_back(it->phi());
+      }
+      clean_.assign(jetEtas_.size(), 1);
+      nClean_ = jetEtas_.size();
+    }
+
+    /// flag the jets with an object of this collection within deltaRMin
+    template <typename C> void removeOverlaps(const C& objects) {
+      if (nClean_ == 0) return;
+      objEtas_.clear();
+      objPhis_.clear();
+      for (typename C::const_iterator it = objects.begin(); it != objects.end(); ++it) {
+        objEtas_.push_back(it->eta());
+        objPhis_.push_back(it->phi());
+      }
+      removeOverlaps();
+    }
+
+    bool isClean(unsigned int iJet) const { return clean_[iJet]; }
+    /// number of jets still clean; once 0, removeOverlaps has nothing left to match
+    unsigned int nClean() const { return nClean_; }
+
+  private:
+    void removeOverlaps();
+
+    double deltaRMin_;
+    double deltaR2Min_;
+    unsigned int maxPairsForPairwise_;
+
+    std::vector<double> jetEtas_;
+    std::vector<double> jetPhis_;
+    std::vector<double> objEtas_;
+    std::vector<double> objPhis_;
+    std::vector<char>   clean_;
+    unsigned int        nClean_;
+
+    EtaPhiGrid          objectGrid_;
+  };
+
+}
+
+#endif
@@ -28,6 +28,7 @@
 #include "TTree.h" 
 #include "TMath.h" 
 #include <TLorentzVector.h>
+#include "TStopwatch.h"
 
 #include "FWCore/Framework/interface/Event.h" 
 #include "FWCore/Framework/interface/Frameworkfwd.h"
@@ -62,11 +63,11 @@ namespace ewk {
 
 
     /// default constructor
-    JetTreeFiller() {};
+    JetTreeFiller() : qglikeli(0), mTimeJets(false), nTimedJets_(0) {};
 
 
-    /// Destructor, does nothing 
-      ~JetTreeFiller() {delete qglikeli;};
+    /// Destructor, prints the per-jet timing summary if requested
+      ~JetTreeFiller();
 
 
 
@@ -102,7 +103,7 @@ namespace ewk {
       void fillEnergyFractionsPFjets(const T1& pfjet, int iJet);
 
     void fillQGLH(int iJet, float fastjet_rho, 
-		  std::vector<reco::PFCandidatePtr> pfCandidates);
+		  const std::vector<reco::PFCandidatePtr>& pfCandidates);
 
     template<typename T1>
       void fillPileUpJetID ( const edm::Handle<edm::View<T1> > &);
@@ -152,6 +153,18 @@ namespace ewk {
     mutable std::vector<std::string> bnames;
     QGLikelihoodCalculator *qglikeli;
 
+    /// time spent in the PF energy-fraction/QGL part, per jet
+    std::string name_;
+    bool mTimeJets;
+    TStopwatch jetTimer_;
+    unsigned long nTimedJets_;
+
+    /// per-jet scratch, reused across jets and events
+    std::vector<reco::PFCandidatePtr> pfCandidates_;
+    std::vector<double> candPt_;
+    std::vector<double> candEta_;
+    std::vector<double> candPhi_;
+
 
   private:
     // private data members
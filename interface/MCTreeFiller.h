@@ -28,6 +28,7 @@
 #include "FWCore/Framework/interface/Event.h" 
 #include "FWCore/Framework/interface/Frameworkfwd.h"
 #include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "ElectroWeakAnalysis/VPlusJets/interface/GenParticleIndex.h"
 
 
 namespace ewk {
@@ -68,6 +69,8 @@ namespace ewk {
     int pdgIdDau_;
     edm::InputTag mInputBoson;
     edm::InputTag mInputgenParticles;
+    /// status-3 buckets and decay links of the current event
+    GenParticleIndex genIndex_;
 
   private:
     // private data members
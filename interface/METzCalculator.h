@@ -32,9 +32,14 @@ class METzCalculator {
 	/// to be compatible with earlier code.
 	/// The values are from the 2010 PDG tables.
 	void SetLeptonType(std::string leptonName) {
-	  if(leptonName == "muon")      leptonMass_ = 0.105658367;
-          if(leptonName == "electron")  leptonMass_ = 0.00051099891;
-          if(leptonName == "tau")       leptonMass_ = 1.77682;
+	  leptonMass_ = LeptonMass(leptonName, leptonMass_);
+	}
+	/// lepton mass for "muon", "electron" or "tau"; defaultMass otherwise
+	static double LeptonMass(const std::string& leptonName, double defaultMass = 0.105658367) {
+	  if(leptonName == "muon")      return 0.105658367;
+          if(leptonName == "electron")  return 0.00051099891;
+          if(leptonName == "tau")       return 1.77682;
+	  return defaultMass;
 	}
 
     /// Calculate MEz
@@ -56,6 +61,21 @@ class METzCalculator {
 	  if ( option == 1 ) return newPtneutrino1_;
 	  else return newPtneutrino2_;
 	}
+
+	/// Result of the stateless solver, same meaning as the accessors above
+	struct Solution {
+	  double pz;
+	  double otherSol;
+	  bool   isComplex;
+	  double ptNeutrino1;
+	  double ptNeutrino2;
+	};
+	/// Stateless version of Calculate on plain numbers: lepton (px,py,pz,E),
+	/// MET (px,py,E) and lepton mass; no allocation, safe to call from threads.
+	static Solution Solve(double pxl, double pyl, double pzl, double el,
+			      double pxnu, double pynu, double enu,
+			      double leptonMass, int type = 0);
+
 	void Print() {
 		std::cout << " METzCalculator: pxmu = " << lepton_.Px() << " pzmu= " << lepton_.Pz() << std::endl;
 		std::cout << " METzCalculator: pxnu = " << MET_.Px() << " pynu= " << MET_.Py() << std::endl;
@@ -0,0 +1,67 @@
+/*****************************************************************************
+ * Project: CMS detector at the CERN
+ *
+ * Package: ElectroWeakAnalysis/VPlusJets
+ *
+ *
+ * Authors:
+ *
+ *   Kalanand Mishra, Fermilab - kalanand@fnal.gov
+ *
+ * Description:
+ *   Conversion-safe electron veto for photons. The gsfElectrons are keyed
+ *   by supercluster once per event, so that the veto of each photon only
+ *   looks at the electrons of its own supercluster instead of scanning all
+ *   of them; the conversion match of an electron is done at most once per
+ *   event, and only when a photon asks for it. The decision is the same as
+ *   !ConversionTools::hasMatchedPromptElectron(...) with its default cuts.
+ * History:
+ *   
+ *
+ * Copyright (C) 2013 FNAL 
+ *****************************************************************************/
+
+#ifndef ElectroWeakAnalysis_VPlusJets_PhotonElectronVeto_h
+#define ElectroWeakAnalysis_VPlusJets_PhotonElectronVeto_h
+
+#include <vector>
+#include <utility>
+
+#include "FWCore/Common/interface/EventBase.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/EgammaReco/interface/SuperClusterFwd.h"
+#include "DataFormats/EgammaCandidates/interface/GsfElectronFwd.h"
+#include "DataFormats/EgammaCandidates/interface/ConversionFwd.h"
+#include "DataFormats/Math/interface/Point3D.h"
+
+namespace ewk {
+
+  class PhotonElectronVeto {
+  public:
+
+    PhotonElectronVeto() {};
+    ~PhotonElectronVeto() {};
+
+    /// To be called once per event, before any passElectronVeto;
+    /// takes an edm::Event or an fwlite::Event
+    void fill(const edm::EventBase &iEvent);
+
+    /// true if no prompt electron shares the photon supercluster
+    bool passElectronVeto(const reco::SuperClusterRef& sc) const;
+
+  private:
+    /// no expected inner hit and no matched conversion, cached per electron
+    bool isPrompt(unsigned int iElectron) const;
+
+    edm::Handle<reco::GsfElectronCollection> electrons_;
+    edm::Handle<reco::ConversionCollection> conversions_;
+    math::XYZPoint beamspot_;
+    /// (supercluster, electron index) of every electron, sorted by supercluster
+    std::vector<std::pair<reco::SuperClusterRef, unsigned int> > electronSCs_;
+    /// per electron: -1 not looked at yet, 0 not prompt, 1 prompt
+    mutable std::vector<signed char> prompt_;
+  };
+
+} //namespace
+
+#endif
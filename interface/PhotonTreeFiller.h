@@ -34,6 +34,7 @@
 #include "DataFormats/Common/interface/ValueMap.h"
 
 #include "EGamma/EGammaAnalysisTools/interface/PFIsolationEstimator.h"
+#include "ElectroWeakAnalysis/VPlusJets/interface/PhotonElectronVeto.h"
 
 namespace ewk {
 
@@ -131,6 +132,7 @@ namespace ewk {
     int Id2012[NUM_PHO_MAX];
 
     PFIsolationEstimator isolator;
+    PhotonElectronVeto electronVeto;
 
   //Pfiso variables
   float  charged03;
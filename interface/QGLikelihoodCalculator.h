@@ -8,6 +8,7 @@
 // ------------------------------------------------------------
 
 #include <string>
+#include <vector>
 
 #include "TFile.h"
 #include "TH1F.h"
@@ -19,9 +20,7 @@ class QGLikelihoodCalculator {
  public:
 
   QGLikelihoodCalculator( const std::string& fileName="QG_QCD_Pt_15to3000_TuneZ2_Flat_7TeV_pythia6_Spring11-PU_S1_START311_V1G1-v1.root", unsigned nPtBins=20, unsigned int nRhoBins=17 );
-  virtual ~QGLikelihoodCalculator() {
-		histoFile_->Close(); 
-	};
+  virtual ~QGLikelihoodCalculator() {};
 
   float computeQGLikelihood( float pt, int nCharged, int nNeutral, float ptD, float rmsCand=-1. );
   float computeQGLikelihoodPU( float pt, float rhoPF, int nCharged, int nNeutral, float ptD, float rmsCand=-1. );
@@ -32,10 +31,35 @@ class QGLikelihoodCalculator {
 
  private:
 
-  TFile* histoFile_;
+  // unit-area normalised copy of one likelihood histogram, 
+  // including under- and overflow
+  struct Histo {
+    Histo() : valid(false), nBins(0), xmin(0.), xmax(0.) {};
+    bool valid;
+    int nBins;
+    double xmin;
+    double xmax;
+    std::vector<double> edges;   // only filled for variable binning
+    std::vector<float> content;
+    float value( float x ) const;
+  };
+
+  enum Variable { nCharged_ = 0, nNeutral_, ptD_, rmsCand_, nVariables_ };
+
+  void loadHisto( TFile* file, const char* name, Histo& histo );
+  int ptBin( float pt, bool lowerEdgeIncluded ) const;
+  int rhoBin( float rhoPF ) const;
+  float tableLikelihood( const Histo* histos, bool useNeutral, int nCharged, int nNeutral, float ptD, float rmsCand ) const;
 
   unsigned int nPtBins_;
   unsigned int nRhoBins_;
 
+  std::vector<double> ptBins_;
+  std::vector<double> rhoBins_;
+
+  // [ptBin][variable][gluon/quark] and [ptBin][rhoBin][variable][gluon/quark]
+  std::vector<Histo> histos_;
+  std::vector<Histo> histosPU_;
+
 };
 
@@ -34,6 +34,7 @@
 #include "FWCore/Framework/interface/EDAnalyzer.h"
 #include "DataFormats/Common/interface/ValueMap.h"
 #include "EGamma/EGammaAnalysisTools/interface/PFIsolationEstimator.h"
+#include "ElectroWeakAnalysis/VPlusJets/interface/PhotonElectronVeto.h"
 
 
 namespace ewk {
@@ -55,11 +56,36 @@ namespace ewk {
 
   protected:
 
+    /// one variable-length block of the tree (muons, tracks, ...): the 
+    /// number of entries of the event and the cap on it. Entries beyond 
+    /// the cap are dropped and counted instead of overrunning the buffers.
+    struct Block {
+      Block() : size(0), cap(0), nOverflow(0), totalOverflow(0) {}
+      /// slot for the next entry, -1 once the block is full
+      int next() { 
+        if (size < cap) return size++; 
+        nOverflow++; totalOverflow++; 
+        return -1; 
+      }
+      void clear() { size = 0; nOverflow = 0; }
+      std::string name;
+      int size;
+      int cap;
+      int nOverflow;
+      long totalOverflow;
+    };
+
     /// Helper function for main constructor 
     void SetBranch( float* x, std::string brName );
     void SetBranch( int* x, std::string brName );
     void SetBranch( bool* x, std::string brName );
     void SetBranch( float x, std::string brName );
+    /// size and overflow counters of a block, "<name>_size" and "<name>_nOverflow"
+    void SetBranch( Block& block );
+    /// per-entry buffer of a block, allocated once to the block's cap
+    void SetBranch( std::vector<float>& x, std::string brName, const Block& block );
+    void SetBranch( std::vector<int>& x, std::string brName, const Block& block );
+    void setCap( Block& block, std::string name, const edm::ParameterSet& caps, int defaultCap );
     float EAch( float x);
     float EAnh( float x);
     float EApho( float x);
@@ -75,6 +101,7 @@ namespace ewk {
     TTree*  tree_;
     edm::InputTag mInputJets;
     PFIsolationEstimator isolator;
+    PhotonElectronVeto electronVeto_;
     typedef std::vector< edm::Handle< edm::ValueMap<double> > > IsoDepositVals;
 
     int run;
@@ -84,111 +111,112 @@ namespace ewk {
     int nPV; 
     float fastJetRho;
     
-    int l1size;
-    int l2size;
-    int jet_size;
-    int photon_size;
-    int genPart_size;
-    int genjet_size;
-    int track_size;
-    int gsftrack_size;
-    int superCluster_size;
-    int superCluster5x5_size;
-    int caloTower_size;
-    int tau_size;
-
-    int l1Charge[999];
-    int l2Charge[999];
-
-    float l1px[999];
-    float l1py[999];
-    float l1pz[999];
-    float l1E[999];
-    float l1Pt[999];
-    float l1Eta[999];
-    float l1Phi[999];
-    float l1Vx[999];
-    float l1Vy[999];
-    float l1Vz[999];
-    float l1Y[999];
-    float l1trackiso[999];
-    float l1ecaliso[999];
-    float l1hcaliso[999];
-    int   l1Type[999];
-    float l1_numberOfChambers[999];      
-    float l1_numberOfMatches[999];
-    float l1pfiso_sumChargedHadronPt[999];
-    float l1pfiso_sumChargedParticlePt[999];
-    float l1pfiso_sumNeutralHadronEt[999];
-    float l1pfiso_sumPhotonEt[999];
-    float l1pfiso_sumPUPt[999];
-    float l1_d0bsp[999];
-    float l1_dz000[999];
-    float l1_IP3D[999];
-    float l1_dzPV[999];
-    float l1_globalChi2[999];
-    float l1_innerChi2[999];
-    float l1_nPixelHits[999];
-    float l1_nTrackerHits[999];
-    int l1_isPF[999];
-    int l1_isGlobal[999];
-    int l1_isTracker[999];
-    int l1_hasMuonSegment[999];
+    /// entry counters of the variable-length blocks of the tree
+    Block muons_;
+    Block electrons_;
+    Block jets_;
+    Block photons_;
+    Block genParticles_;
+    Block genjets_;
+    Block tracks_;
+    Block gsftracks_;
+    Block superClusters_;
+    Block superClusters5x5_;
+    Block caloTowers_;
+    Block taus_;
+
+    std::vector<int> l1Charge;
+    std::vector<int> l2Charge;
+
+    std::vector<float> l1px;
+    std::vector<float> l1py;
+    std::vector<float> l1pz;
+    std::vector<float> l1E;
+    std::vector<float> l1Pt;
+    std::vector<float> l1Eta;
+    std::vector<float> l1Phi;
+    std::vector<float> l1Vx;
+    std::vector<float> l1Vy;
+    std::vector<float> l1Vz;
+    std::vector<float> l1Y;
+    std::vector<float> l1trackiso;
+    std::vector<float> l1ecaliso;
+    std::vector<float> l1hcaliso;
+    std::vector<int>   l1Type;
+    std::vector<float> l1_numberOfChambers;      
+    std::vector<float> l1_numberOfMatches;
+    std::vector<float> l1pfiso_sumChargedHadronPt;
+    std::vector<float> l1pfiso_sumChargedParticlePt;
+    std::vector<float> l1pfiso_sumNeutralHadronEt;
+    std::vector<float> l1pfiso_sumPhotonEt;
+    std::vector<float> l1pfiso_sumPUPt;
+    std::vector<float> l1_d0bsp;
+    std::vector<float> l1_dz000;
+    std::vector<float> l1_IP3D;
+    std::vector<float> l1_dzPV;
+    std::vector<float> l1_globalChi2;
+    std::vector<float> l1_innerChi2;
+    std::vector<float> l1_nPixelHits;
+    std::vector<float> l1_nTrackerHits;
+    std::vector<int> l1_isPF;
+    std::vector<int> l1_isGlobal;
+    std::vector<int> l1_isTracker;
+    std::vector<int> l1_hasMuonSegment;
 
     ///////////////////
-    float l2px[999];
-    float l2py[999];
-    float l2pz[999];
-    float l2E[999];
-    float l2Pt[999];
-    float l2Eta[999];
-    float l2Phi[999];
-    float l2Vx[999];
-    float l2Vy[999];
-    float l2Vz[999];
-    float l2Y[999];  
-    float l2trackiso[999];
-    float l2ecaliso[999];
-    float l2hcaliso[999];
-    int   l2_classification[999];
-    float l2_HoverE[999]; 
-    float l2_EoverP[999];
-    float l2_DeltaEta[999];
-    float l2_DeltaPhi[999];
-    int   l2_numberOfBrems[999];      
-    float l2_BremFraction[999];
-    float l2_SigmaIetaIeta[999];
-    int   l2_missingHits[999];
-    float l2_dist[999];
-    float l2_dcot[999];
-    float l2_convradius[999];
-    float l2pfiso_chargedHadronIso[999];
-    float l2pfiso_photonIso[999];
-    float l2pfiso_neutralHadronIso[999];
-    float l2pfiso_EffAreaPU[999];
-    float l2pfiso_pfIsoEA[999];
-    float l2_d0bsp[999];
-    float l2_dz000[999];
-    float l2_IP3D[999];
-    float l2_dzPV[999];
+    std::vector<float> l2px;
+    std::vector<float> l2py;
+    std::vector<float> l2pz;
+    std::vector<float> l2E;
+    std::vector<float> l2Pt;
+    std::vector<float> l2Eta;
+    std::vector<float> l2Phi;
+    std::vector<float> l2Vx;
+    std::vector<float> l2Vy;
+    std::vector<float> l2Vz;
+    std::vector<float> l2Y;  
+    std::vector<float> l2trackiso;
+    std::vector<float> l2ecaliso;
+    std::vector<float> l2hcaliso;
+    std::vector<int>   l2_classification;
+    std::vector<float> l2_HoverE; 
+    std::vector<float> l2_EoverP;
+    std::vector<float> l2_DeltaEta;
+    std::vector<float> l2_DeltaPhi;
+    std::vector<int>   l2_numberOfBrems;      
+    std::vector<float> l2_BremFraction;
+    std::vector<float> l2_SigmaIetaIeta;
+    std::vector<int>   l2_missingHits;
+    std::vector<float> l2_dist;
+    std::vector<float> l2_dcot;
+    std::vector<float> l2_convradius;
+    std::vector<float> l2pfiso_chargedHadronIso;
+    std::vector<float> l2pfiso_photonIso;
+    std::vector<float> l2pfiso_neutralHadronIso;
+    std::vector<float> l2pfiso_EffAreaPU;
+    std::vector<float> l2pfiso_pfIsoEA;
+    std::vector<float> l2_d0bsp;
+    std::vector<float> l2_dz000;
+    std::vector<float> l2_IP3D;
+    std::vector<float> l2_dzPV;
 
 
     ///////////////////
-    float jet_px[999];
-    float jet_py[999];
-    float jet_pz[999];
-    float jet_E[999];
-    float jet_Pt[999];
-    float jet_Eta[999];
-    float jet_Phi[999];
-    float jet_Y[999];
-    float jet_area[999];
-    float jet_bDiscriminatorSSVHE[999];
-    float jet_bDiscriminatorTCHE[999];
-    float jet_bDiscriminatorCSV[999];
-    float jet_bDiscriminatorJP[999];
-    float jet_bDiscriminatorSSVHP[999];
-    float jet_bDiscriminatorTCHP[999];
+    std::vector<float> jet_px;
+    std::vector<float> jet_py;
+    std::vector<float> jet_pz;
+    std::vector<float> jet_E;
+    std::vector<float> jet_Pt;
+    std::vector<float> jet_Eta;
+    std::vector<float> jet_Phi;
+    std::vector<float> jet_Y;
+    std::vector<float> jet_area;
+    std::vector<float> jet_bDiscriminatorSSVHE;
+    std::vector<float> jet_bDiscriminatorTCHE;
+    std::vector<float> jet_bDiscriminatorCSV;
+    std::vector<float> jet_bDiscriminatorJP;
+    std::vector<float> jet_bDiscriminatorSSVHP;
+    std::vector<float> jet_bDiscriminatorTCHP;
  
     ///////////////////
     float Met_px;
@@ -198,111 +226,111 @@ namespace ewk {
     float Met_SumET;
 
     ///////////////////
-    float photon_px[999];
-    float photon_py[999];
-    float photon_pz[999];
-    float photon_E[999];
-    float photon_pt[999];
-    float photon_eta[999];
-    float photon_phi[999];
-    float photon_vx[999];
-    float photon_vy[999];
-    float photon_vz[999];
-    float photon_pfiso_charged[999];
-    float photon_pfiso_photon[999];
-    float photon_pfiso_neutral[999];
-    float photon_trackiso[999];
-    float photon_ecaliso[999];
-    float photon_hcaliso[999];
-    float photon_HoverE[999];
-    float photon_SigmaIetaIeta[999];
-    int photon_hasPixelSeed[999];
-    int photon_passElecVeto[999];
+    std::vector<float> photon_px;
+    std::vector<float> photon_py;
+    std::vector<float> photon_pz;
+    std::vector<float> photon_E;
+    std::vector<float> photon_pt;
+    std::vector<float> photon_eta;
+    std::vector<float> photon_phi;
+    std::vector<float> photon_vx;
+    std::vector<float> photon_vy;
+    std::vector<float> photon_vz;
+    std::vector<float> photon_pfiso_charged;
+    std::vector<float> photon_pfiso_photon;
+    std::vector<float> photon_pfiso_neutral;
+    std::vector<float> photon_trackiso;
+    std::vector<float> photon_ecaliso;
+    std::vector<float> photon_hcaliso;
+    std::vector<float> photon_HoverE;
+    std::vector<float> photon_SigmaIetaIeta;
+    std::vector<int> photon_hasPixelSeed;
+    std::vector<int> photon_passElecVeto;
 
     ///////////////////
-    float track_px[999];
-    float track_py[999];
-    float track_pz[999];
-    float track_Vx[999];
-    float track_Vy[999];
-    float track_Vz[999];
-    float track_Pt[999];
-    float track_Eta[999];
-    float track_Phi[999];
+    std::vector<float> track_px;
+    std::vector<float> track_py;
+    std::vector<float> track_pz;
+    std::vector<float> track_Vx;
+    std::vector<float> track_Vy;
+    std::vector<float> track_Vz;
+    std::vector<float> track_Pt;
+    std::vector<float> track_Eta;
+    std::vector<float> track_Phi;
 
     ///////////////////
-    float gsftrack_px[999];
-    float gsftrack_py[999];
-    float gsftrack_pz[999];
-    float gsftrack_Vx[999];
-    float gsftrack_Vy[999];
-    float gsftrack_Vz[999];
-    float gsftrack_Pt[999];
-    float gsftrack_Eta[999];
-    float gsftrack_Phi[999];
+    std::vector<float> gsftrack_px;
+    std::vector<float> gsftrack_py;
+    std::vector<float> gsftrack_pz;
+    std::vector<float> gsftrack_Vx;
+    std::vector<float> gsftrack_Vy;
+    std::vector<float> gsftrack_Vz;
+    std::vector<float> gsftrack_Pt;
+    std::vector<float> gsftrack_Eta;
+    std::vector<float> gsftrack_Phi;
 
     ///////////////////
-    float superCluster_E    [999];
-    float superCluster_rawE [999];
-    float superCluster_x    [999];
-    float superCluster_y    [999];
-    float superCluster_z    [999];
-    float superCluster_Eta  [999];
-    float superCluster_Phi  [999];
-    float superCluster_nHits[999];
+    std::vector<float> superCluster_E;
+    std::vector<float> superCluster_rawE;
+    std::vector<float> superCluster_x;
+    std::vector<float> superCluster_y;
+    std::vector<float> superCluster_z;
+    std::vector<float> superCluster_Eta;
+    std::vector<float> superCluster_Phi;
+    std::vector<float> superCluster_nHits;
 
     ///////////////////
-    float superCluster5x5_E    [999];
-    float superCluster5x5_rawE [999];
-    float superCluster5x5_x    [999];
-    float superCluster5x5_y    [999];
-    float superCluster5x5_z    [999];
-    float superCluster5x5_Eta  [999];
-    float superCluster5x5_Phi  [999];
-    float superCluster5x5_nHits[999];
+    std::vector<float> superCluster5x5_E;
+    std::vector<float> superCluster5x5_rawE;
+    std::vector<float> superCluster5x5_x;
+    std::vector<float> superCluster5x5_y;
+    std::vector<float> superCluster5x5_z;
+    std::vector<float> superCluster5x5_Eta;
+    std::vector<float> superCluster5x5_Phi;
+    std::vector<float> superCluster5x5_nHits;
 
     ///////////////////
-    float caloTower_hadE [999];
-    float caloTower_emE  [999];
-    float caloTower_hadEt[999];
-    float caloTower_emEt [999];
-    float caloTower_Eta  [999];
-    float caloTower_Phi  [999];
+    std::vector<float> caloTower_hadE;
+    std::vector<float> caloTower_emE;
+    std::vector<float> caloTower_hadEt;
+    std::vector<float> caloTower_emEt;
+    std::vector<float> caloTower_Eta;
+    std::vector<float> caloTower_Phi;
 
     ///////////////////
-    float tau_px[999];
-    float tau_py[999];
-    float tau_pz[999];
-    float tau_Pt[999];
-    float tau_Eta[999];
-    float tau_Phi[999];
+    std::vector<float> tau_px;
+    std::vector<float> tau_py;
+    std::vector<float> tau_pz;
+    std::vector<float> tau_Pt;
+    std::vector<float> tau_Eta;
+    std::vector<float> tau_Phi;
 
     ///////////////////
-    int genPart_Charge[9999];
-    float genPart_px[9999];
-    float genPart_py[9999];
-    float genPart_pz[9999];
-    float genPart_E[9999];
-    float genPart_Pt[9999];
-    float genPart_Eta[9999];
-    float genPart_Phi[9999];
-    float genPart_Vx[9999];
-    float genPart_Vy[9999];
-    float genPart_Vz[9999];
-    float genPart_Y[9999];
+    std::vector<int> genPart_Charge;
+    std::vector<float> genPart_px;
+    std::vector<float> genPart_py;
+    std::vector<float> genPart_pz;
+    std::vector<float> genPart_E;
+    std::vector<float> genPart_Pt;
+    std::vector<float> genPart_Eta;
+    std::vector<float> genPart_Phi;
+    std::vector<float> genPart_Vx;
+    std::vector<float> genPart_Vy;
+    std::vector<float> genPart_Vz;
+    std::vector<float> genPart_Y;
 
     ///////////////////
-    float genjet_px[999];
-    float genjet_py[999];
-    float genjet_pz[999];
-    float genjet_E[999];
-    float genjet_Pt[999];
-    float genjet_Eta[999];
-    float genjet_Phi[999];
-    float genjet_Y[999];
-    float genjet_area[999];
-    int genPart_Status[999];
-    int genPart_pdgId[999];
+    std::vector<float> genjet_px;
+    std::vector<float> genjet_py;
+    std::vector<float> genjet_pz;
+    std::vector<float> genjet_E;
+    std::vector<float> genjet_Pt;
+    std::vector<float> genjet_Eta;
+    std::vector<float> genjet_Phi;
+    std::vector<float> genjet_Y;
+    std::vector<float> genjet_area;
+    std::vector<int> genPart_Status;
+    std::vector<int> genPart_pdgId;
 
   };
 
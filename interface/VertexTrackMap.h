@@ -0,0 +1,60 @@
+/*****************************************************************************
+ * Project: CMS detector at the CERN
+ *
+ * Package: ElectroWeakAnalysis/VPlusJets
+ *
+ *
+ * Authors:
+ *   A. Marini, K. Kousouris,  K. Theofilatos
+ *
+ * Description:
+ *   Per-event track -> vertex association of the good primary vertices
+ *   (not fake, ndof >= 4), built once from the vertex track lists so that
+ *   the jet beta/betaStar need one lookup per jet track.
+ * History:
+ *
+ *****************************************************************************/
+
+#ifndef ElectroWeakAnalysis_VPlusJets_VertexTrackMap_h
+#define ElectroWeakAnalysis_VPlusJets_VertexTrackMap_h
+
+#include <vector>
+#include <map>
+#include <utility>
+
+#include "DataFormats/Provenance/interface/ProductID.h"
+#include "DataFormats/VertexReco/interface/Vertex.h"
+#include "DataFormats/VertexReco/interface/VertexFwd.h"
+#include "DataFormats/TrackReco/interface/Track.h"
+#include "DataFormats/TrackReco/interface/TrackFwd.h"
+
+namespace ewk {
+
+  class VertexTrackMap {
+  public:
+
+    VertexTrackMap() {};
+    ~VertexTrackMap() {};
+
+    /// To be called once per event
+    void fill(const reco::VertexCollection& vertices);
+
+    /// how many times the track appears in the first vertex (if good) and in
+    /// the other good vertices
+    std::pair<int,int> vertexCounts(const reco::TrackRef& trk) const;
+
+    /// pt fraction of the tracks from the first vertex (beta) and from the
+    /// other good vertices (betaStar); both stay -1 without tracks
+    void betaAndBetaStar(const reco::TrackRefVector& tracks, float& beta, float& betaStar) const;
+
+  private:
+    /// counts of the tracks of the dominant track collection, by key ...
+    edm::ProductID productId_;
+    std::vector< std::pair<int,int> > countsByKey_;
+    /// ... and of any other collection
+    std::map< std::pair<edm::ProductID, unsigned int>, std::pair<int,int> > otherCounts_;
+  };
+
+}
+
+#endif
@@ -38,10 +38,12 @@
 
 #include "ElectroWeakAnalysis/VPlusJets/interface/JetTreeFiller.h"
 #include "ElectroWeakAnalysis/VPlusJets/interface/GroomedJetFiller.h"
+#include "ElectroWeakAnalysis/VPlusJets/interface/GroomedJetParticleCache.h"
 #include "ElectroWeakAnalysis/VPlusJets/interface/PhotonTreeFiller.h"
 #include "ElectroWeakAnalysis/VPlusJets/interface/VtoElectronTreeFiller.h"
 #include "ElectroWeakAnalysis/VPlusJets/interface/VtoMuonTreeFiller.h"
 #include "ElectroWeakAnalysis/VPlusJets/interface/MCTreeFiller.h"
+#include "ElectroWeakAnalysis/VPlusJets/interface/FillerTimer.h"
 #include "FWCore/ServiceRegistry/interface/Service.h"
 #include "CommonTools/UtilAlgos/interface/TFileService.h"
 
@@ -96,6 +98,10 @@ namespace ewk
     std::auto_ptr<ewk::GroomedJetFiller> genCA8groomedJetFiller;
     std::auto_ptr<ewk::GroomedJetFiller> genCA12groomedJetFiller;
 
+    /// fastjet inputs, rho and nPV shared by all the groomed jet fillers
+    ewk::GroomedJetParticleCache groomedJetParticles;
+    std::vector<ewk::GroomedJetFiller*> groomedJetFillers;
+
 
     std::auto_ptr<ewk::JetTreeFiller> GenJetFiller;
     std::auto_ptr<ewk::PhotonTreeFiller> PhotonFiller;
@@ -103,6 +109,12 @@ namespace ewk
     std::auto_ptr<ewk::VtoMuonTreeFiller> recoBosonFillerMu;
     std::auto_ptr<ewk::MCTreeFiller> genBosonFiller;
 
+    /// optional cost accounting of the fillers ("timeFillers"), summarised at endJob
+    ewk::FillerTimer fillerTimer;
+    unsigned int tGenJets, tPhotons, tPFCorJets, tPFCorVBFTagJets, tGroomedJetParticles;
+    std::vector<unsigned int> tGroomedJets;
+    unsigned int tBosonE, tBosonMu, tGenBoson, tTreeFill;
+
 
     // private data members
     int run;
@@ -0,0 +1,131 @@
+/*****************************************************************************
+ * Project: CMS detector at the CERN
+ *
+ * Package: ElectroWeakAnalysis/VPlusJets
+ *
+ *
+ * Authors:
+ *   A. Marini, K. Kousouris,  K. Theofilatos
+ *
+ * Description:
+ *   Eta-phi grid index for deltaR cone queries.
+ * History:
+ *
+ *****************************************************************************/
+
+#include "ElectroWeakAnalysis/VPlusJets/interface/EtaPhiGrid.h"
+#include "DataFormats/Math/interface/deltaR.h"
+
+#include <cmath>
+#include <algorithm>
+
+
+ewk::EtaPhiGrid::EtaPhiGrid(double cellSize, double etaMax)
+  : cellSize_(cellSize), etaMax_(etaMax)
+{
+  // the cell size only sets the speed; keep the number of cells bounded
+  if (cellSize_ < 0.05) cellSize_ = 0.05;
+  nEta_ = std::max(1, (int) std::ceil(2*etaMax_/cellSize_));
+  nPhi_ = std::max(1, (int) std::floor(2*M_PI/cellSize_));
+}
+
+
+
+void ewk::EtaPhiGrid::fill(const std::vector<double>& etas, const std::vector<double>& phis)
+{
+  etas_ = etas;
+  phis_ = phis;
+  build();
+}
+
+
+
+int ewk::EtaPhiGrid::etaBin(double eta) const
+{
+  int bin = (int) std::floor((eta + etaMax_)/cellSize_);
+  return std::min(std::max(bin, 0), nEta_-1);
+}
+
+
+
+int ewk::EtaPhiGrid::phiBin(double phi) const
+{
+  // cells cover [-pi, pi) in nPhi_ equal slices
+  int bin = (int) std::floor((reco::deltaPhi(phi, 0.) + M_PI)*nPhi_/(2*M_PI));
+  return ((bin % nPhi_) + nPhi_) % nPhi_;
+}
+
+
+
+void ewk::EtaPhiGrid::build()
+{
+  // counting sort of the objects into their cells
+  const unsigned int nCells = nEta_*nPhi_;
+  std::vector<unsigned int> cell(etas_.size());
+  cellStart_.assign(nCells+1, 0);
+  for (unsigned int i = 0; i < etas_.size(); i++) {
+    cell[i] = etaBin(etas_[i])*nPhi_ + phiBin(phis_[i]);
+    cellStart_[cell[i]+1]++;
+  }
+  for (unsigned int c = 0; c < nCells; c++) cellStart_[c+1] += cellStart_[c];
+  cellItems_.resize(etas_.size());
+  std::vector<unsigned int> next(cellStart_.begin(), cellStart_.end()-1);
+  for (unsigned int i = 0; i < etas_.size(); i++) cellItems_[next[cell[i]]++] = i;
+}
+
+
+
+namespace {
+  struct ConeCollector {
+    std::vector<unsigned int>* indices;
+    bool operator()(unsigned int i) { indices->push_back(i); return false; }
+  };
+  struct ConeFinder {
+    bool operator()(unsigned int) { return true; }
+  };
+}
+
+
+
+template <typename V> 
+bool ewk::EtaPhiGrid::visit(double eta, double phi, double R, V& visitor) const
+{
+  if (etas_.empty()) return false;
+  const double R2 = R*R;
+  const int eta1 = etaBin(eta - R), eta2 = etaBin(eta + R);
+  // neighbouring phi cells, without visiting any cell twice
+  const int dPhi = (int) std::ceil(R*nPhi_/(2*M_PI));
+  const int phi0 = phiBin(phi);
+  const int nPhiCells = std::min(2*dPhi+1, nPhi_);
+  for (int ie = eta1; ie <= eta2; ie++) {
+    for (int k = 0; k < nPhiCells; k++) {
+      const int ip = (((phi0 - dPhi + k) % nPhi_) + nPhi_) % nPhi_;
+      const unsigned int c = ie*nPhi_ + ip;
+      for (unsigned int j = cellStart_[c]; j < cellStart_[c+1]; j++) {
+        const unsigned int i = cellItems_[j];
+        if (reco::deltaR2(eta, phi, etas_[i], phis_[i]) < R2 && visitor(i)) return true;
+      }
+    }
+  }
+  return false;
+}
+
+
+
+void ewk::EtaPhiGrid::coneIndices(double eta, double phi, double R, std::vector<unsigned int>& indices) const
+{
+  indices.clear();
+  ConeCollector collector;
+  collector.indices = &indices;
+  visit(eta, phi, R, collector);
+  // collection order, so that sums over the cone add up as in a plain loop
+  std::sort(indices.begin(), indices.end());
+}
+
+
+
+bool ewk::EtaPhiGrid::anyInCone(double eta, double phi, double R) const
+{
+  ConeFinder finder;
+  return visit(eta, phi, R, finder);
+}
@@ -0,0 +1,224 @@
+/*****************************************************************************
+ * Project: CMS detector at the CERN
+ *
+ * Package: ElectroWeakAnalysis/VPlusJets
+ *
+ *
+ * Authors:
+ *
+ *   Kalanand Mishra, Fermilab - kalanand@fnal.gov
+ *
+ * Description:
+ *   Opt-in per-step cost accounting for the tree fillers.
+ * History:
+ *
+ *
+ * Copyright (C) 2013 FNAL
+ *****************************************************************************/
+
+#include "ElectroWeakAnalysis/VPlusJets/interface/FillerTimer.h"
+
+#include <cmath>
+#include <ctime>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <sys/time.h>
+
+
+// defined by test/Benchmarks/allocationCounter.c when it is preloaded
+extern "C" unsigned long ewkAllocationCount() __attribute__((weak));
+
+
+namespace {
+
+  const int    kBinsPerDecade = 10;
+  const double kMinMs         = 1e-3;   // 1 us
+  const double kMinAllocs     = 1.;
+  const int    kNBins         = 9*kBinsPerDecade;
+
+  double wallMs() {
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return tv.tv_sec*1e3 + tv.tv_usec*1e-3;
+  }
+
+  double cpuMs() { return std::clock()*(1e3/CLOCKS_PER_SEC); }
+
+  unsigned long allocationCount() { return ewkAllocationCount ? ewkAllocationCount() : 0; }
+
+}
+
+
+
+ewk::FillerTimer::Distribution::Distribution(double minValue)
+  : counts(kNBins+1, 0), n(0), sum(0.), min(minValue)
+{}
+
+
+
+void ewk::FillerTimer::Distribution::add(double value)
+{
+  int bin = 0;
+  if (value > min) bin = std::min(kNBins, 1 + (int) std::floor(kBinsPerDecade*std::log10(value/min)));
+  counts[bin]++;
+  n++;
+  sum += value;
+}
+
+
+
+double ewk::FillerTimer::Distribution::quantile(double q) const
+{
+  // upper edge of the bin holding the quantile
+  if (n == 0) return 0.;
+  const double target = q*n;
+  unsigned long cumulative = 0;
+  for (int bin = 0; bin <= kNBins; bin++) {
+    cumulative += counts[bin];
+    if (cumulative >= target) return min*std::pow(10., (double) bin/kBinsPerDecade);
+  }
+  return min*std::pow(10., (double) kNBins/kBinsPerDecade);
+}
+
+
+
+ewk::FillerTimer::Step::Step()
+  : wallStart(0.), cpuStart(0.), allocStart(0), wall(0.), cpu(0.), allocs(0), touched(false),
+    wallMs(kMinMs), cpuMs(kMinMs), allocations(kMinAllocs)
+{}
+
+
+
+ewk::FillerTimer::FillerTimer(bool enabled)
+  : enabled_(enabled), countAllocations_(enabled && ewkAllocationCount != 0)
+{}
+
+
+
+unsigned int ewk::FillerTimer::addStep(const std::string& name)
+{
+  for (unsigned int i = 0; i < steps_.size(); i++)
+    if (steps_[i].name == name) return i;
+  Step step;
+  step.name = name;
+  steps_.push_back(step);
+  return steps_.size()-1;
+}
+
+
+
+void ewk::FillerTimer::start(unsigned int step)
+{
+  if (!enabled_) return;
+  Step& s = steps_[step];
+  s.cpuStart  = cpuMs();
+  s.wallStart = wallMs();
+  if (countAllocations_) s.allocStart = allocationCount();
+}
+
+
+
+void ewk::FillerTimer::stop(unsigned int step)
+{
+  if (!enabled_) return;
+  const unsigned long allocs = countAllocations_ ? allocationCount() : 0;
+  const double wall = wallMs(), cpu = cpuMs();
+  Step& s = steps_[step];
+  s.wall += wall - s.wallStart;
+  s.cpu  += cpu - s.cpuStart;
+  s.allocs += allocs - s.allocStart;
+  s.touched = true;
+}
+
+
+
+void ewk::FillerTimer::endEvent()
+{
+  if (!enabled_) return;
+  for (unsigned int i = 0; i < steps_.size(); i++) {
+    Step& s = steps_[i];
+    if (!s.touched) continue;
+    s.wallMs.add(s.wall);
+    s.cpuMs.add(s.cpu);
+    if (countAllocations_) s.allocations.add(s.allocs);
+    s.wall = s.cpu = 0.;
+    s.allocs = 0;
+    s.touched = false;
+  }
+}
+
+
+
+void ewk::FillerTimer::writeSummary(TTree* tree) const
+{
+  char name[256];
+  int nEvents;
+  float wallMean, wall50, wall90, wall99;
+  float cpuMean, cpu50, cpu90, cpu99;
+  float allocMean, alloc50, alloc90, alloc99;
+  tree->Branch("step",      name,      "step/C");
+  tree->Branch("nEvents",   &nEvents,  "nEvents/I");
+  tree->Branch("wallMean",  &wallMean, "wallMean/F");
+  tree->Branch("wall50",    &wall50,   "wall50/F");
+  tree->Branch("wall90",    &wall90,   "wall90/F");
+  tree->Branch("wall99",    &wall99,   "wall99/F");
+  tree->Branch("cpuMean",   &cpuMean,  "cpuMean/F");
+  tree->Branch("cpu50",     &cpu50,    "cpu50/F");
+  tree->Branch("cpu90",     &cpu90,    "cpu90/F");
+  tree->Branch("cpu99",     &cpu99,    "cpu99/F");
+  tree->Branch("allocMean", &allocMean, "allocMean/F");
+  tree->Branch("alloc50",   &alloc50,  "alloc50/F");
+  tree->Branch("alloc90",   &alloc90,  "alloc90/F");
+  tree->Branch("alloc99",   &alloc99,  "alloc99/F");
+
+  for (unsigned int i = 0; i < steps_.size(); i++) {
+    const Step& s = steps_[i];
+    snprintf(name, sizeof(name), "%s", s.name.c_str());
+    nEvents  = s.wallMs.n;
+    wallMean = nEvents ? s.wallMs.sum/nEvents : 0.;
+    wall50   = s.wallMs.quantile(0.50);
+    wall90   = s.wallMs.quantile(0.90);
+    wall99   = s.wallMs.quantile(0.99);
+    cpuMean  = nEvents ? s.cpuMs.sum/nEvents : 0.;
+    cpu50    = s.cpuMs.quantile(0.50);
+    cpu90    = s.cpuMs.quantile(0.90);
+    cpu99    = s.cpuMs.quantile(0.99);
+    allocMean = alloc50 = alloc90 = alloc99 = -1.;
+    if (countAllocations_) {
+      allocMean = nEvents ? s.allocations.sum/nEvents : 0.;
+      alloc50   = s.allocations.quantile(0.50);
+      alloc90   = s.allocations.quantile(0.90);
+      alloc99   = s.allocations.quantile(0.99);
+    }
+    tree->Fill();
+  }
+  // the branch addresses are local to this function
+  tree->ResetBranchAddresses();
+}
+
+
+
+void ewk::FillerTimer::printSummary(std::ostream& out) const
+{
+  char line[512];
+  out << "++++++++++++++++++++++++++++++++++++++++++++++++++" << std::endl;
+  out << "FillerTimer SUMMARY: per-event cost, wall/cpu in ms, allocations in calls" << std::endl;
+  snprintf(line, sizeof(line), "%-40s %8s %9s %9s %9s %9s %9s",
+	   "step", "events", "wallMean", "wall50", "wall99", "cpuMean", "cpu99");
+  if (countAllocations_)
+    snprintf(line + strlen(line), sizeof(line) - strlen(line), " %10s", "allocMean");
+  out << line << std::endl;
+  for (unsigned int i = 0; i < steps_.size(); i++) {
+    const Step& s = steps_[i];
+    const unsigned long n = s.wallMs.n;
+    if (n == 0) continue;
+    snprintf(line, sizeof(line), "%-40s %8lu %9.3f %9.3f %9.3f %9.3f %9.3f",
+	     s.name.c_str(), n, s.wallMs.sum/n, s.wallMs.quantile(0.50), s.wallMs.quantile(0.99),
+	     s.cpuMs.sum/n, s.cpuMs.quantile(0.99));
+    if (countAllocations_)
+      snprintf(line + strlen(line), sizeof(line) - strlen(line), " %10.1f", s.allocations.sum/n);
+    out << line << std::endl;
+  }
+  out << "++++++++++++++++++++++++++++++++++++++++++++++++++" << std::endl;
+}
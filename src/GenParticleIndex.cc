@@ -0,0 +1,100 @@
+/*****************************************************************************
+ * Project: CMS detector at the CERN
+ *
+ * Package: ElectroWeakAnalysis/VPlusJets
+ *
+ *
+ * Authors:
+ *
+ *   Kalanand Mishra, Fermilab - kalanand@fnal.gov
+ *
+ * Description:
+ *   Per-event index of a reco::GenParticleCollection.
+ * History:
+ *   
+ *
+ * Copyright (C) 2010 FNAL 
+ *****************************************************************************/
+
+#include "ElectroWeakAnalysis/VPlusJets/interface/GenParticleIndex.h"
+
+
+ewk::GenParticleIndex::GenParticleIndex() :
+  byPdgId_(MAX_BUCKET_PDGID+1), nStatus3Partons_(0)
+{
+}
+
+
+
+void ewk::GenParticleIndex::fill(const edm::Handle<reco::GenParticleCollection>& genParticles)
+{
+  genParticles_ = genParticles;
+  const size_t nGen = genParticles->size();
+
+  status3_.clear();
+  for(size_t id = 0; id < byPdgId_.size(); ++id) byPdgId_[id].clear();
+  nStatus3Partons_ = 0;
+  mothers_.assign(1, 0);
+  motherKeys_.clear();
+  daughters_.assign(1, 0);
+  daughterKeys_.clear();
+  mothers_.reserve(nGen+1);
+  daughters_.reserve(nGen+1);
+
+  for(size_t i = 0; i < nGen; ++i) {
+    const reco::GenParticle& p = (*genParticles)[i];
+
+    if( abs(p.status())==3 ) {
+      status3_.push_back(i);
+      if( abs(p.pdgId()) <= MAX_BUCKET_PDGID ) byPdgId_[abs(p.pdgId())].push_back(i);
+    }
+    if( p.status()==3 && isParton(p.pdgId()) ) nStatus3Partons_++;
+
+    // links into this same collection only
+    const reco::GenParticleRefVector& moms = p.motherRefVector();
+    for(size_t k = 0; k < moms.size(); ++k)
+      if( moms[k].id() == genParticles.id() && moms[k].key() < nGen ) motherKeys_.push_back(moms[k].key());
+    mothers_.push_back(motherKeys_.size());
+
+    const reco::GenParticleRefVector& daus = p.daughterRefVector();
+    for(size_t k = 0; k < daus.size(); ++k)
+      if( daus[k].id() == genParticles.id() && daus[k].key() < nGen ) daughterKeys_.push_back(daus[k].key());
+    daughters_.push_back(daughterKeys_.size());
+  }
+}
+
+
+
+const std::vector<int>& ewk::GenParticleIndex::status3(int absPdgId) const
+{
+  if( absPdgId < 0 || absPdgId > MAX_BUCKET_PDGID ) return empty_;
+  return byPdgId_[absPdgId];
+}
+
+
+
+std::pair<const int*, const int*> 
+ewk::GenParticleIndex::range(const std::vector<int>& offsets, const std::vector<int>& keys, int i) const
+{
+  if( keys.empty() ) return std::make_pair((const int*) 0, (const int*) 0);
+  const int* base = &keys[0];
+  return std::make_pair(base + offsets[i], base + offsets[i+1]);
+}
+
+
+
+void ewk::GenParticleIndex::status3PartonSiblings(int i, std::vector<int>& siblings) const
+{
+  siblings.clear();
+  std::pair<const int*, const int*> moms = mothers(i);
+  for(const int* m = moms.first; m != moms.second; ++m) {
+    std::pair<const int*, const int*> daus = daughters(*m);
+    for(const int* d = daus.first; d != daus.second; ++d) {
+      if( *d == i ) continue;
+      const reco::GenParticle& p = at(*d);
+      if( !(abs(p.status())==3 && isParton(p.pdgId())) ) continue;
+      if( std::find(siblings.begin(), siblings.end(), *d) == siblings.end() ) siblings.push_back(*d);
+    }
+  }
+  std::sort(siblings.begin(), siblings.end());
+}
@@ -7,7 +7,11 @@
 #include "fastjet/FunctionOfPseudoJet.hh"
 
 #include <string>
+#include <vector>
 #include <climits>
+#include <cmath>
+#include <cassert>
+#include <iostream>
 
 
 FASTJET_BEGIN_NAMESPACE      // defined in fastjet/internal/base.hh
@@ -19,6 +23,29 @@ enum ecmode {
 };
 
 
+// Per-jet cache of the inputs of the correlators: the (optionally leading-pT
+// truncated) particle energies and the symmetric matrix angle(i,j)^beta, 
+// stored row-major in one contiguous block.  Every angle^beta is computed once
+// and the N = 2,3,4 sums become plain multiply-adds over contiguous rows.
+class GeneralizedEnergyCorrelatorCache {
+
+public:
+
+   GeneralizedEnergyCorrelatorCache(const PseudoJet& jet, double beta, ecmode mode = pT_R, unsigned int nLeading = 0);
+
+   unsigned int size() const {return _n;}
+   const double* energies() const {return _n ? &_energy[0] : 0;}
+   const double* row(unsigned int i) const {return &_angleBeta[i*_n];}
+
+private:
+
+   unsigned int _n;
+   std::vector<double> _energy;
+   std::vector<double> _angleBeta;
+
+};
+
+
 class GeneralizedEnergyCorrelator : public FunctionOfPseudoJet<double> {
 
 private:
@@ -26,17 +53,22 @@ private:
    int _N;
    double _beta;
    ecmode _mode;
+   unsigned int _nLeading;
 
 public:
 
-   GeneralizedEnergyCorrelator(int N, double beta, ecmode mode = pT_R) : _N(N), _beta(beta), _mode(mode) {};
+   /// nLeading > 0 restricts the sums to the nLeading hardest constituents
+   GeneralizedEnergyCorrelator(int N, double beta, ecmode mode = pT_R, unsigned int nLeading = 0) : _N(N), _beta(beta), _mode(mode), _nLeading(nLeading) {};
    
    double result(const PseudoJet& jet) const;
 
-   double energy(const PseudoJet& jet) const {
-      if (_mode == pT_R) {
+   /// evaluate on a cache built with the same beta and mode
+   double result(const GeneralizedEnergyCorrelatorCache& cache) const;
+
+   static double energy(const PseudoJet& jet, ecmode mode) {
+      if (mode == pT_R) {
          return jet.perp();
-      }  else if (_mode == E_Omega) {
+      }  else if (mode == E_Omega) {
          return jet.e();
       } else {
          assert(false);
@@ -45,10 +77,10 @@ public:
    
    }
    
-   double angle(const PseudoJet& jet1,const PseudoJet& jet2) const {
-      if (_mode == pT_R) {
+   static double angle(const PseudoJet& jet1,const PseudoJet& jet2, ecmode mode) {
+      if (mode == pT_R) {
          return jet1.delta_R(jet2);
-      } else if (_mode == E_Omega) {
+      } else if (mode == E_Omega) {
          // doesn't seem to be a fastjet built in for this
          double dot = jet1.px()*jet2.px() + jet1.py()*jet2.py() + jet1.pz()*jet2.pz();
          double norm1 = sqrt(jet1.px()*jet1.px() + jet1.py()*jet1.py() + jet1.pz()*jet1.pz());
@@ -64,59 +96,91 @@ public:
       }
    }
 
+   double energy(const PseudoJet& jet) const {return energy(jet, _mode);}
+   double angle(const PseudoJet& jet1,const PseudoJet& jet2) const {return angle(jet1, jet2, _mode);}
 
 };
 
-inline double GeneralizedEnergyCorrelator::result(const PseudoJet& jet) const {
+
+inline GeneralizedEnergyCorrelatorCache::GeneralizedEnergyCorrelatorCache(const PseudoJet& jet, double beta, ecmode mode, unsigned int nLeading) {
 
    std::vector<fastjet::PseudoJet> particles = jet.constituents();
+   if (nLeading > 0 && nLeading < particles.size()) {
+      particles = sorted_by_pt(particles);
+      particles.resize(nLeading);
+   }
+
+   _n = particles.size();
+   _energy.resize(_n);
+   _angleBeta.resize(_n*_n);
+   for (unsigned int i = 0; i < _n; i++) {
+      _energy[i] = GeneralizedEnergyCorrelator::energy(particles[i], mode);
+      // the diagonal is kept: pow(0,beta) is what the direct sums add for i == j
+      for (unsigned int j = i; j < _n; j++) {
+         double angleBeta = pow(GeneralizedEnergyCorrelator::angle(particles[i],particles[j],mode), beta);
+         _angleBeta[i*_n + j] = angleBeta;
+         _angleBeta[j*_n + i] = angleBeta;
+      }
+   }
+
+}
+
+
+inline double GeneralizedEnergyCorrelator::result(const PseudoJet& jet) const {
+
+   if (_N == 0) return 1.0;
+   return result(GeneralizedEnergyCorrelatorCache(jet, _beta, _mode, _nLeading));
+
+}
+
+
+inline double GeneralizedEnergyCorrelator::result(const GeneralizedEnergyCorrelatorCache& cache) const {
+
+   const unsigned int n = cache.size();
+   const double* E = cache.energies();
 
    double answer = 0.0;
 
    if (_N == 0) {
       return 1.0;
    } else if (_N == 1) {
-      for (unsigned int i = 0; i < particles.size(); i++) {
-         answer += energy(particles[i]);
+      for (unsigned int i = 0; i < n; i++) {
+         answer += E[i];
       }
    } else if (_N == 2) {
-      for (unsigned int i = 0; i < particles.size(); i++) {
-         for (unsigned int j = i; j < particles.size(); j++) {
-            answer += energy(particles[i])
-                        * energy(particles[j])
-                        * pow(angle(particles[i],particles[j]), _beta);
+      for (unsigned int i = 0; i < n; i++) {
+         const double* Ai = cache.row(i);
+         double sum_j = 0.0;
+         for (unsigned int j = i; j < n; j++) {
+            sum_j += E[j] * Ai[j];
          }
+         answer += E[i] * sum_j;
       }   
    
    } else if (_N == 3) {
-      for (unsigned int i = 0; i < particles.size(); i++) {
-         for (unsigned int j = i; j < particles.size(); j++) {
-            for (unsigned int k = j; k < particles.size(); k++) {
-               answer += energy(particles[i])
-                        * energy(particles[j])
-                        * energy(particles[k])
-                        * pow(angle(particles[i],particles[j])
-                              * angle(particles[i],particles[k])
-                              * angle(particles[j],particles[k]), _beta);
+      for (unsigned int i = 0; i < n; i++) {
+         const double* Ai = cache.row(i);
+         for (unsigned int j = i; j < n; j++) {
+            const double* Aj = cache.row(j);
+            double sum_k = 0.0;
+            for (unsigned int k = j; k < n; k++) {
+               sum_k += E[k] * Ai[k] * Aj[k];
             }
+            answer += E[i] * E[j] * Ai[j] * sum_k;
          }
       }
    } else if (_N == 4) {
-      for (unsigned int i = 0; i < particles.size(); i++) {
-         for (unsigned int j = i; j < particles.size(); j++) {
-            for (unsigned int k = j; k < particles.size(); k++) {
-               for (unsigned int l = k; l < particles.size(); l++) {
-                  answer += energy(particles[i])
-                        * energy(particles[j])
-                        * energy(particles[k])
-                        * energy(particles[l])
-                        * pow(angle(particles[i],particles[j])
-                           * angle(particles[i],particles[k])
-                           * angle(particles[j],particles[k])
-                           * angle(particles[i],particles[l])
-                           * angle(particles[j],particles[l])
-                           * angle(particles[k],particles[l]), _beta);
+      for (unsigned int i = 0; i < n; i++) {
+         const double* Ai = cache.row(i);
+         for (unsigned int j = i; j < n; j++) {
+            const double* Aj = cache.row(j);
+            for (unsigned int k = j; k < n; k++) {
+               const double* Ak = cache.row(k);
+               double sum_l = 0.0;
+               for (unsigned int l = k; l < n; l++) {
+                  sum_l += E[l] * Ai[l] * Aj[l] * Ak[l];
                }
+               answer += E[i] * E[j] * E[k] * Ai[j] * Ai[k] * Aj[k] * sum_l;
             }
          }
       }
@@ -139,10 +203,11 @@ private:
    int _N;
    double _beta;
    ecmode _mode;
+   unsigned int _nLeading;
 
 public:
 
-   GeneralizedEnergyCorrelatorRatio(int N, double beta, ecmode mode = pT_R) : _N(N), _beta(beta), _mode(mode) {};
+   GeneralizedEnergyCorrelatorRatio(int N, double beta, ecmode mode = pT_R, unsigned int nLeading = 0) : _N(N), _beta(beta), _mode(mode), _nLeading(nLeading) {};
    
    double result(const PseudoJet& jet) const;
 
@@ -151,8 +216,11 @@ public:
 
 inline double GeneralizedEnergyCorrelatorRatio::result(const PseudoJet& jet) const {
 
-   double numerator = GeneralizedEnergyCorrelator(_N - 1, _beta, _mode).result(jet) * GeneralizedEnergyCorrelator(_N + 1, _beta, _mode).result(jet);
-   double denominator = pow(GeneralizedEnergyCorrelator(_N, _beta, _mode).result(jet), 2.0);
+   // the three correlators share one angle^beta matrix
+   GeneralizedEnergyCorrelatorCache cache(jet, _beta, _mode, _nLeading);
+
+   double numerator = GeneralizedEnergyCorrelator(_N - 1, _beta, _mode).result(cache) * GeneralizedEnergyCorrelator(_N + 1, _beta, _mode).result(cache);
+   double denominator = pow(GeneralizedEnergyCorrelator(_N, _beta, _mode).result(cache), 2.0);
 
    return numerator/denominator;
 
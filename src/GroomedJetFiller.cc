@@ -47,14 +47,27 @@
 #include "fastjet/tools/Pruner.hh"
 #include "fastjet/tools/MassDropTagger.hh"
 #include "fastjet/GhostedAreaSpec.hh"
+#include "fastjet/Selector.hh"
 
 //#include "ElectroWeakAnalysis/VPlusJets/interface/Nsubjettiness.h"
 #include "ElectroWeakAnalysis/VPlusJets/src/NjettinessPlugin.hh"
 #include "ElectroWeakAnalysis/VPlusJets/src/Nsubjettiness.hh"
+#include "ElectroWeakAnalysis/VPlusJets/src/NsubjettinessBatch.hh"
 #include "ElectroWeakAnalysis/VPlusJets/src/QjetsPlugin.h"
 #include "ElectroWeakAnalysis/VPlusJets/src/GeneralizedEnergyCorrelator.hh"
 #include "TVector3.h"
 #include "TMath.h"
+#include <thread>
+#include <limits>
+#include <algorithm>
+#include <fnmatch.h>
+
+namespace {
+        // input particle order, as carried in user_index
+    bool lessUserIndex(const fastjet::PseudoJet& a, const fastjet::PseudoJet& b){
+        return a.user_index() < b.user_index();
+    }
+}
 
 ewk::GroomedJetFiller::GroomedJetFiller(const char *name, 
                                         TTree* tree, 
@@ -65,6 +78,7 @@ ewk::GroomedJetFiller::GroomedJetFiller(const char *name,
     tree_     = tree;
     jetLabel_ = jetLabel;
     isGenJ = isGen;
+    timer_ = 0;
     
     lableGen = "";
     if(isGen) lableGen = "Gen";
@@ -88,6 +102,12 @@ ewk::GroomedJetFiller::GroomedJetFiller(const char *name,
     std::cout << "jet algo: " << mJetAlgo << ", jet radius: " << mJetRadius << std::endl;
     mJetRadius /= 10.;
     
+        // branches not matching any of these globs are neither declared nor
+        // computed, e.g. [ "GroomedJet_CA8_pt*", "GroomedJet_CA8_mass_pr" ]
+    if( iConfig.existsAs<std::vector<std::string> >("GroomedJet_activeBranches") ) 
+        mActiveBranches=iConfig.getParameter< std::vector<std::string> >("GroomedJet_activeBranches");
+    else mActiveBranches = std::vector<std::string>(1, "*");
+    
         // Declare all the branches of the tree
     SetBranch( jetpt_uncorr, lableGen + "GroomedJet_" + jetLabel_ + "_pt_uncorr");
     SetBranch( jetmass_uncorr, lableGen + "GroomedJet_" + jetLabel_ + "_mass_uncorr");
@@ -160,40 +180,29 @@ ewk::GroomedJetFiller::GroomedJetFiller(const char *name,
     SetBranch( jetGeneralizedECF, lableGen + "GroomedJet_" + jetLabel_ + "_jetGeneralizedECF");
 
         // cores
-    tree_->Branch( (lableGen + "GroomedJet_" + jetLabel_ + "_rcores").c_str(), rcores, (lableGen + "GroomedJet_" + jetLabel_ + "_rcores"+"[11][6]/F").c_str() );
-    bnames.push_back( (lableGen + "GroomedJet_" + jetLabel_ + "_rcores").c_str() );
-    tree_->Branch( (lableGen + "GroomedJet_" + jetLabel_ + "_ptcores").c_str(), ptcores, (lableGen + "GroomedJet_" + jetLabel_ + "_ptcores"+"[11][6]/F").c_str() );
-    bnames.push_back( (lableGen + "GroomedJet_" + jetLabel_ + "_ptcores").c_str() );
+    SetBranchLeaf( rcores, lableGen + "GroomedJet_" + jetLabel_ + "_rcores", "[11][6]/F" );
+    SetBranchLeaf( ptcores, lableGen + "GroomedJet_" + jetLabel_ + "_ptcores", "[11][6]/F" );
     
     //planarflow
-    tree_->Branch((lableGen + "GroomedJet_" + jetLabel_ + "_planarflow").c_str(),planarflow, (lableGen + "GroomedJet_" + jetLabel_ + "_planarflow"+"[11][6]/F").c_str());
-    bnames.push_back( (lableGen + "GroomedJet_" + jetLabel_ + "_planarflow").c_str() );
+    SetBranchLeaf( planarflow, lableGen + "GroomedJet_" + jetLabel_ + "_planarflow", "[11][6]/F" );
 
         // qjets
-    tree_->Branch( (lableGen + "GroomedJet_" + jetLabel_ + "_qjetmass").c_str(), qjetmass, (lableGen + "GroomedJet_" + jetLabel_ + "_qjetmass"+"[50]/F").c_str() );
-    bnames.push_back( (lableGen + "GroomedJet_" + jetLabel_ + "_qjetmass").c_str() );
-    tree_->Branch( (lableGen + "GroomedJet_" + jetLabel_ + "_qjetmassdrop").c_str(), qjetmassdrop, (lableGen + "GroomedJet_" + jetLabel_ + "_qjetmassdrop"+"[50]/F").c_str() );
-    bnames.push_back( (lableGen + "GroomedJet_" + jetLabel_ + "_qjetmassdrop").c_str() );
+    SetBranchLeaf( qjetmass, lableGen + "GroomedJet_" + jetLabel_ + "_qjetmass", "[50]/F" );
+    SetBranchLeaf( qjetmassdrop, lableGen + "GroomedJet_" + jetLabel_ + "_qjetmassdrop", "[50]/F" );
 
     if( iConfig.existsAs<bool>("GroomedJet_saveConstituents") ) 
         mSaveConstituents=iConfig.getParameter< bool >("GroomedJet_saveConstituents");
     else mSaveConstituents = true;
 
     if (mSaveConstituents){
-        tree_->Branch( (lableGen + "GroomedJet_" + jetLabel_ + "_constituents0_eta").c_str(), constituents0_eta, (lableGen + "GroomedJet_" + jetLabel_ + "_constituents0_eta"+"[100]/F").c_str() );
-        bnames.push_back( (lableGen + "GroomedJet_" + jetLabel_ + "_constituents0_eta").c_str() );   
-        tree_->Branch( (lableGen + "GroomedJet_" + jetLabel_ + "_constituents0_phi").c_str(), constituents0_phi, (lableGen + "GroomedJet_" + jetLabel_ + "_constituents0_phi"+"[100]/F").c_str() );
-        bnames.push_back( (lableGen + "GroomedJet_" + jetLabel_ + "_constituents0_phi").c_str() );   
-        tree_->Branch( (lableGen + "GroomedJet_" + jetLabel_ + "_constituents0_e").c_str(), constituents0_e, (lableGen + "GroomedJet_" + jetLabel_ + "_constituents0_e"+"[100]/F").c_str() );
-        bnames.push_back( (lableGen + "GroomedJet_" + jetLabel_ + "_constituents0_e").c_str() );   
+        SetBranchLeaf( constituents0_eta, lableGen + "GroomedJet_" + jetLabel_ + "_constituents0_eta", "[100]/F" );
+        SetBranchLeaf( constituents0_phi, lableGen + "GroomedJet_" + jetLabel_ + "_constituents0_phi", "[100]/F" );
+        SetBranchLeaf( constituents0_e, lableGen + "GroomedJet_" + jetLabel_ + "_constituents0_e", "[100]/F" );
         SetBranchSingle( &nconstituents0, lableGen + "GroomedJet_" + jetLabel_ + "_nconstituents0" );
         
-        tree_->Branch( (lableGen + "GroomedJet_" + jetLabel_ + "_constituents0pr_eta").c_str(), constituents0pr_eta, (lableGen + "GroomedJet_" + jetLabel_ + "_constituents0pr_eta"+"[100]/F").c_str() );
-        bnames.push_back( (lableGen + "GroomedJet_" + jetLabel_ + "_constituents0pr_eta").c_str() );   
-        tree_->Branch( (lableGen + "GroomedJet_" + jetLabel_ + "_constituents0pr_phi").c_str(), constituents0pr_phi, (lableGen + "GroomedJet_" + jetLabel_ + "_constituents0pr_phi"+"[100]/F").c_str() );
-        bnames.push_back( (lableGen + "GroomedJet_" + jetLabel_ + "_constituents0pr_phi").c_str() );   
-        tree_->Branch( (lableGen + "GroomedJet_" + jetLabel_ + "_constituents0pr_e").c_str(), constituents0pr_e, (lableGen + "GroomedJet_" + jetLabel_ + "_constituents0pr_e"+"[100]/F").c_str() );
-        bnames.push_back( (lableGen + "GroomedJet_" + jetLabel_ + "_constituents0pr_e").c_str() );   
+        SetBranchLeaf( constituents0pr_eta, lableGen + "GroomedJet_" + jetLabel_ + "_constituents0pr_eta", "[100]/F" );
+        SetBranchLeaf( constituents0pr_phi, lableGen + "GroomedJet_" + jetLabel_ + "_constituents0pr_phi", "[100]/F" );
+        SetBranchLeaf( constituents0pr_e, lableGen + "GroomedJet_" + jetLabel_ + "_constituents0pr_e", "[100]/F" );
         SetBranchSingle( &nconstituents0pr, lableGen + "GroomedJet_" + jetLabel_ + "_nconstituents0pr" );
     }
     
@@ -283,6 +292,16 @@ ewk::GroomedJetFiller::GroomedJetFiller(const char *name,
     if( iConfig.existsAs<bool>("GroomedJet_doQJets") ) 
         mDoQJets=iConfig.getParameter< bool >("GroomedJet_doQJets");
     else mDoQJets = true;
+        // Qjets trials are seeded per event and per trial, so they can be spread over threads
+    if( iConfig.existsAs<int>("GroomedJet_QJetsNThreads") ) 
+        mQJetsNThreads=iConfig.getParameter< int >("GroomedJet_QJetsNThreads");
+    else mQJetsNThreads = 1;
+        // cluster once with explicit ghosts and strip the ghosts from the jet constituents,
+        // instead of clustering a second time without ghosts; the pruned subjets and the
+        // Qjets preclustering then come from the ghost-free constituents of the jet
+    if( iConfig.existsAs<bool>("GroomedJet_singleClustering") ) 
+        mSingleClustering=iConfig.getParameter< bool >("GroomedJet_singleClustering");
+    else mSingleClustering = false;
 
         // define charges of pdgIds
     neutrals.push_back( 22 ); neutrals.push_back( 130 ); neutrals.push_back( 310 ); neutrals.push_back( 311 ); neutrals.push_back( 111 ); 
@@ -293,40 +312,166 @@ ewk::GroomedJetFiller::GroomedJetFiller(const char *name,
     positives.push_back( 321 ); positives.push_back( 211 ); ; positives.push_back( -11 ); positives.push_back( -13); positives.push_back( 2212);
     negatives.push_back( -321 ); negatives.push_back( -211 ); negatives.push_back( 11 ); negatives.push_back( 13 );
     
+    setComputations();
     
+        // clustering, grooming and substructure tools, the same for every event
+    if (mJetAlgo == "AK") mJetDef = fastjet::JetDefinition(fastjet::antikt_algorithm, mJetRadius);
+    else if (mJetAlgo == "CA") mJetDef = fastjet::JetDefinition(fastjet::cambridge_algorithm, mJetRadius);
+    else throw cms::Exception("GroomedJetFiller") << " unknown jet algorithm " << mJetAlgo << std::endl;
+
+    int activeAreaRepeats = 1;
+    double ghostArea = 0.01;
+    double ghostEtaMax = 5.0;
+    fastjet::GhostedAreaSpec fjActiveArea(ghostEtaMax,activeAreaRepeats,ghostArea);
+    fjActiveArea.set_fj2_placement(true);
+    mAreaDef = fastjet::AreaDefinition( fastjet::active_area_explicit_ghosts, fjActiveArea );
+    mNoGhosts = !fastjet::SelectorIsPureGhost();
+
+        // trimmer, filter, pruner, in the order expected by fill
+    mTransformers.push_back( new fastjet::Filter(fastjet::JetDefinition(fastjet::kt_algorithm, 0.2), fastjet::SelectorPtFractionMin(0.03)) );
+    mTransformers.push_back( new fastjet::Filter(fastjet::JetDefinition(fastjet::cambridge_algorithm, 0.3), fastjet::SelectorNHardest(3)) );
+    mTransformers.push_back( new fastjet::Pruner(fastjet::cambridge_algorithm, 0.1, 0.5) );
+        // the C/A clustering of the pruner, for the pruned subjets in single-clustering mode
+    mPrunedSubjetDef = fastjet::JetDefinition(fastjet::cambridge_algorithm, fastjet::JetDefinition::max_allowable_R);
+
+        // tau_1..tau_4 for kt and onepass_kt axes; beta, R0 = Rcut = jet radius
+    mNsubKT = new fastjet::NsubjettinessBatch(4, mNsubjettinessKappa, mJetRadius, mJetRadius);
+
+    mECFJetDef = fastjet::JetDefinition(fastjet::antikt_algorithm, 2.0);
+    mECFRatio = new fastjet::GeneralizedEnergyCorrelatorRatio(2,1.7,fastjet::pT_R); // beta = 1.7
+
+        // each Qjets thread reseeds its own plugin for every trial
+    double zcut(0.1), dcut_fctr(0.5), exp_min(0.), exp_max(0.), rigidity(0.1);                
+    for (int t = 0; t < std::max(1, mQJetsNThreads); ++t)
+        mQjetPlugins.push_back( new QjetsPlugin(zcut, dcut_fctr, exp_min, exp_max, rigidity) );
+
+        // C/A radii R = 0.0 ... 1.0 (cores) and 0.1 ... 1.1 (planar flow) below the jet radius
+    for (int kk = 0; kk < 12; ++kk){
+        double coreCtr = (double) kk;
+        if (coreCtr < mJetRadius*10.) mScanRadii.push_back(coreCtr/10.);
+    }
+    mPdgIds.reserve(200);
+    mTausKT.reserve(4);
+    mTausOnepass.reserve(4);
+}
+
+
+
+ewk::GroomedJetFiller::~GroomedJetFiller()
+{
+    for (unsigned int i = 0; i < mTransformers.size(); ++i) delete mTransformers[i];
+    for (unsigned int i = 0; i < mQjetPlugins.size(); ++i) delete mQjetPlugins[i];
+    delete mNsubKT;
+    delete mECFRatio;
 }
 
 
 
+void ewk::GroomedJetFiller::setComputations()
+{
+        // branches (after the "GroomedJet_<label>" prefix) filled by each optional calculation
+    struct Dependency { Computation computation; const char* branch; };
+    static const Dependency dependencies[] = {
+        { cTrimming, "_mass_tr_uncorr" }, { cTrimming, "_pt_tr_uncorr" }, { cTrimming, "_pt_tr" }, { cTrimming, "_eta_tr" },
+        { cTrimming, "_phi_tr" }, { cTrimming, "_e_tr" }, { cTrimming, "_mass_tr" }, { cTrimming, "_area_tr" },
+        { cFiltering, "_mass_ft_uncorr" }, { cFiltering, "_pt_ft_uncorr" }, { cFiltering, "_pt_ft" }, { cFiltering, "_eta_ft" },
+        { cFiltering, "_phi_ft" }, { cFiltering, "_e_ft" }, { cFiltering, "_mass_ft" }, { cFiltering, "_area_ft" },
+        { cPruning, "_mass_pr_uncorr" }, { cPruning, "_pt_pr_uncorr" }, { cPruning, "_pt_pr" }, { cPruning, "_eta_pr" },
+        { cPruning, "_phi_pr" }, { cPruning, "_e_pr" }, { cPruning, "_mass_pr" }, { cPruning, "_area_pr" },
+        { cPrunedNsubjettiness, "_tau1_pr" }, { cPrunedNsubjettiness, "_tau2_pr" }, { cPrunedNsubjettiness, "_tau3_pr" }, 
+        { cPrunedNsubjettiness, "_tau4_pr" }, { cPrunedNsubjettiness, "_tau2tau1_pr" },
+        { cPrunedSubjets, "_prsubjet1_px" }, { cPrunedSubjets, "_prsubjet1_py" }, { cPrunedSubjets, "_prsubjet1_pz" }, 
+        { cPrunedSubjets, "_prsubjet1_e" }, { cPrunedSubjets, "_prsubjet2_px" }, { cPrunedSubjets, "_prsubjet2_py" }, 
+        { cPrunedSubjets, "_prsubjet2_pz" }, { cPrunedSubjets, "_prsubjet2_e" }, { cPrunedSubjets, "_massdrop_pr" }, 
+        { cPrunedSubjets, "_massdrop_pr_uncorr" }, { cPrunedSubjets, "_constituents0pr_eta" }, 
+        { cPrunedSubjets, "_constituents0pr_phi" }, { cPrunedSubjets, "_constituents0pr_e" }, { cPrunedSubjets, "_nconstituents0pr" },
+        { cNsubjettiness, "_tau1" }, { cNsubjettiness, "_tau2" }, { cNsubjettiness, "_tau3" }, { cNsubjettiness, "_tau4" }, 
+        { cNsubjettiness, "_tau2tau1" },
+        { cNsubjettinessExkT, "_tau1_exkT" }, { cNsubjettinessExkT, "_tau2_exkT" }, { cNsubjettinessExkT, "_tau3_exkT" }, 
+        { cNsubjettinessExkT, "_tau4_exkT" }, { cNsubjettinessExkT, "_tau2tau1_exkT" },
+        { cCores, "_rcores" }, { cCores, "_ptcores" },
+        { cPlanarflow, "_planarflow" },
+        { cQJets, "_qjetmass" }, { cQJets, "_qjetmassdrop" },
+        { cJetCharge, "_jetcharge" }, { cJetCharge, "_jetcharge_k05" }, { cJetCharge, "_jetcharge_k07" }, { cJetCharge, "_jetcharge_k10" },
+        { cGeneralizedECF, "_jetGeneralizedECF" }
+    };
+    const char* names[nComputations] = { "trimming", "filtering", "pruning", "pruned n-subjettiness", "pruned subjets", 
+                                         "n-subjettiness", "exclusive-kt n-subjettiness", "cores", "planarflow", "qjets", 
+                                         "jet charge", "generalized ECF" };
+
+    for (int i = 0; i < nComputations; ++i) mCompute[i] = false;
+    for (unsigned int i = 0; i < sizeof(dependencies)/sizeof(dependencies[0]); ++i)
+        if (isActive( name() + dependencies[i].branch )) mCompute[dependencies[i].computation] = true;
+        // the pruned jet is the input of the pruned n-subjettiness and subjets
+    if (mCompute[cPrunedNsubjettiness] || mCompute[cPrunedSubjets]) mCompute[cPruning] = true;
+
+    std::string skipped;
+    for (int i = 0; i < nComputations; ++i)
+        if (!mCompute[i]) skipped += std::string(skipped.empty() ? "" : ", ") + names[i];
+    if (!skipped.empty()) std::cout << name() << ": no active branches, not computing " << skipped << std::endl;
+}
+
+
+
+
+void ewk::GroomedJetFiller::registerInputs(GroomedJetParticleCache& particleCache) const
+{
+    if (isGenJ) particleCache.addInput(mGroomedJet, GroomedJetParticleCache::GenParticles);
+    else if (mJetAlgo == "AK" && fabs(mJetRadius-0.5)<0.001) particleCache.addInput(mGroomedJet, GroomedJetParticleCache::PFCandidates);
+    else particleCache.addInput(mGroomedJet, GroomedJetParticleCache::PFInputs);
+}
+
+
+
+void ewk::GroomedJetFiller::setTimer(FillerTimer* timer)
+{
+    timer_ = timer;
+    if (!timer_) return;
+    const char* names[nTimedSteps] = { "clustering", "grooming", "nsubjettiness", "cores", "qjets", "charge_ecf" };
+    for (int i = 0; i < nTimedSteps; ++i)
+        timerSteps_[i] = timer_->addStep(name() + "/" + names[i]);
+}
+
+
 
     //////////////////////////////////////////////////////////////////
     /////// Helper for above function ////////////////////////////////
     //////////////////////////////////////////////////////////////////
     //////////////////////////////////////////////////////////////////
 
-void ewk::GroomedJetFiller::SetBranchSingle( float* x, std::string name)
+bool ewk::GroomedJetFiller::isActive( const std::string& name ) const
+{
+    for (unsigned int i = 0; i < mActiveBranches.size(); ++i)
+        if (fnmatch( mActiveBranches[i].c_str(), name.c_str(), 0 ) == 0) return true;
+    return false;
+}
+
+void ewk::GroomedJetFiller::SetBranchLeaf( void* x, std::string name, std::string leaf )
 {
-    tree_->Branch( name.c_str(), x, ( name+"/F").c_str() );
+    if (!isActive( name )) return;
+    tree_->Branch( name.c_str(), x, ( name+leaf).c_str() );
     bnames.push_back( name );
 }
 
+void ewk::GroomedJetFiller::SetBranchSingle( float* x, std::string name)
+{
+    SetBranchLeaf( x, name, "/F" );
+}
+
 void ewk::GroomedJetFiller::SetBranchSingle( int* x, std::string name)
 {
-    tree_->Branch( name.c_str(), x, ( name+"/I").c_str() );
-    bnames.push_back( name );
+    SetBranchLeaf( x, name, "/I" );
 }
 
 void ewk::GroomedJetFiller::SetBranch( float* x, std::string name)
 {
-    tree_->Branch( name.c_str(), x, ( name+"[6]/F").c_str() );
-    bnames.push_back( name );
+    SetBranchLeaf( x, name, "[6]/F" );
 }
 
 
 void ewk::GroomedJetFiller::SetBranch( int* x, std::string name)
 {
-    tree_->Branch( name.c_str(), x, ( name+"[6]/I").c_str() );
-    bnames.push_back( name );
+    SetBranchLeaf( x, name, "[6]/I" );
 }
 
     //////////////////////////////////////////////////////////////////
@@ -337,7 +482,7 @@ void ewk::GroomedJetFiller::SetBranch( int* x, std::string name)
 
 
     // ------------ method called to produce the data  ------------
-void ewk::GroomedJetFiller::fill(const edm::Event& iEvent) {
+void ewk::GroomedJetFiller::fill(const edm::Event& iEvent, const GroomedJetParticleCache& particleCache) {
                 
         ////----------
         // init
@@ -418,141 +563,48 @@ void ewk::GroomedJetFiller::fill(const edm::Event& iEvent) {
     }
     
 
-        // ----- get handles... --------    
-    std::string pfinput_ = mGroomedJet;    
-    edm::Handle< std::vector<float> > PF_px_handle;
-    edm::Handle< std::vector<float> > PF_py_handle;
-    edm::Handle< std::vector<float> > PF_pz_handle;
-    edm::Handle< std::vector<float> > PF_en_handle;
-    edm::Handle< std::vector<float> > PF_id_handle;
-
-    std::vector<float>  PF_id_handle_AK5;
-    std::vector<float>  PF_id_handle_Gen;
+        // ----- particles, rho and nPV from the shared per-event cache --------    
+    const GroomedJetParticleCache::Particles& inputs = particleCache.particles(mGroomedJet);
+    const std::vector<fastjet::PseudoJet>& FJparticles = inputs.particles;
+    rhoVal_ = particleCache.rho();
+    nPV_ = particleCache.nPV();
     
-    edm::Handle< reco::PFCandidateCollection > pfCandidates;
-    edm::Handle<reco::GenParticleRefVector> genParticles;
-    reco::GenParticleRefVector genParticlesforJets;
-
-    if( isGenJ ) {
-      iEvent.getByLabel(mGroomedJet, genParticles);
-       genParticlesforJets = *genParticles;
-    }else{
-      if(mJetAlgo == "AK" && fabs(mJetRadius-0.5)<0.001) {
-         iEvent.getByLabel(mGroomedJet,"pfCandidates",pfCandidates);
-      }else{
-         iEvent.getByLabel( pfinput_, "px" ,    PF_px_handle);
-         iEvent.getByLabel( pfinput_, "py" ,    PF_py_handle);
-         iEvent.getByLabel( pfinput_, "pz" ,    PF_pz_handle);
-         iEvent.getByLabel( pfinput_, "energy", PF_en_handle);
-         iEvent.getByLabel( pfinput_, "pdgId", PF_id_handle);
-      }
-    }
-
-        // ------ get rho --------    
-    rhoVal_ = -99.;
-    edm::Handle<double> rho;
-    const edm::InputTag eventrho(JetsFor_rho, "rho");
-    iEvent.getByLabel(eventrho,rho);
-    rhoVal_ = *rho;
-    
-        // ------ get nPV: primary/secondary vertices------ 
-    nPV_ = 0.;
-    double nPVval = 0;
-    edm::Handle <edm::View<reco::Vertex> > recVtxs;
-    iEvent.getByLabel( mPrimaryVertex, recVtxs);
-    for(unsigned int ind=0;ind<recVtxs->size();ind++){
-        if (!((*recVtxs)[ind].isFake()) && ((*recVtxs)[ind].ndof()>=4) 
-            && (fabs((*recVtxs)[ind].z())<=24.0) &&  
-            ((*recVtxs)[ind].position().Rho()<=2.0) ) {
-            nPVval += 1;
-        }
-    }
-    nPV_ = nPVval;
-    
-        // ----------------------------
-        // ------ start processing ------    
-    PF_id_handle_AK5.clear();
-    PF_id_handle_Gen.clear();
-    charge_handle_Gen.clear();
-    std::vector<fastjet::PseudoJet> FJparticles;
-    if(isGenJ){
-
-	for(size_t i = 0; i < genParticles->size(); ++ i) {
-             const reco::GenParticle&    P = *(genParticlesforJets[i]);
-             FJparticles.push_back( fastjet::PseudoJet( P.px(), 
- 						  P.py(),
-  						  P.pz(),
-      						  P.energy() ) );
-             PF_id_handle_Gen.push_back(P.pdgId());
-             charge_handle_Gen.push_back(P.charge());
-        }
-
-    }else{
-      if(mJetAlgo == "AK" && fabs(mJetRadius-0.5)<0.001) {
-       for( reco::PFCandidateCollection::const_iterator ci  = pfCandidates->begin(); ci!=pfCandidates->end(); ++ci)  {
-         FJparticles.push_back( fastjet::PseudoJet( ci->px(), 
- 						  ci->py(),
-  						  ci->pz(),
- 						  ci->energy() ) );
-         PF_id_handle_AK5.push_back(ci->translateTypeToPdgId(ci->particleId()));
-       }
-      }else{
-         for (unsigned i = 0; i < PF_px_handle->size() ; i++){
-             FJparticles.push_back( fastjet::PseudoJet( PF_px_handle->at(i), 
-                                                     PF_py_handle->at(i), 
-                                                     PF_pz_handle->at(i), 
-                                                     PF_en_handle->at(i) ) );
-         }
-      }
-    }
-
         // std::cout << "FJparticles.size() = " << FJparticles.size() << std::endl;
     if (FJparticles.size() < 1) return;
     
         // do re-clustering
-    fastjet::JetDefinition jetDef(fastjet::cambridge_algorithm, mJetRadius);
-    if (mJetAlgo == "AK") jetDef.set_jet_algorithm( fastjet::antikt_algorithm );
-    else if (mJetAlgo == "CA") jetDef.set_jet_algorithm( fastjet::cambridge_algorithm );
-    else throw cms::Exception("GroomedJetFiller") << " unknown jet algorithm " << std::endl;
-
-    int activeAreaRepeats = 1;
-    double ghostArea = 0.01;
-    double ghostEtaMax = 5.0;
-        // fastjet::ActiveAreaSpec fjActiveArea(ghostEtaMax,activeAreaRepeats,ghostArea);
-    fastjet::GhostedAreaSpec fjActiveArea(ghostEtaMax,activeAreaRepeats,ghostArea);
-    fjActiveArea.set_fj2_placement(true);
-    fastjet::AreaDefinition fjAreaDefinition( fastjet::active_area_explicit_ghosts, fjActiveArea );
+    startTimer(tClustering);
+    const fastjet::JetDefinition& jetDef = mJetDef;
+        // the ghost placement advances the random generator of the area spec:
+        // start every event from the configured one, as when it was built per event
+    fastjet::AreaDefinition fjAreaDefinition = mAreaDef;
     fastjet::ClusterSequenceArea thisClustering(FJparticles, jetDef, fjAreaDefinition);
     
-    std::vector<fastjet::PseudoJet> out_jets = sorted_by_pt(thisClustering.inclusive_jets(50.0));
+    std::vector<fastjet::PseudoJet>& out_jets = mOutJets;
+    out_jets = sorted_by_pt(thisClustering.inclusive_jets(50.0));
          if(mJetAlgo == "AK" && fabs(mJetRadius-0.5)<0.001)
 				out_jets = sorted_by_pt(thisClustering.inclusive_jets(20.0));
-    fastjet::ClusterSequence thisClustering_basic(FJparticles, jetDef);
-    std::vector<fastjet::PseudoJet> out_jets_basic = sorted_by_pt(thisClustering_basic.inclusive_jets(50.0));
+
+        // ghost-free clustering, skipped in single-clustering mode: the ghosts
+        // (pt ~ 1e-100) change neither the momenta nor the order of the real merges
+    const bool basicClustering = !mSingleClustering;
+    std::auto_ptr<fastjet::ClusterSequence> thisClustering_basic;
+    std::vector<fastjet::PseudoJet>& out_jets_basic = mOutJetsBasic;
+    if (!basicClustering) out_jets_basic = out_jets;
+    else{
+        thisClustering_basic.reset( new fastjet::ClusterSequence(FJparticles, jetDef) );
+        out_jets_basic = sorted_by_pt(thisClustering_basic->inclusive_jets(50.0));
          if(mJetAlgo == "AK" && fabs(mJetRadius-0.5)<0.001)
-				out_jets_basic = sorted_by_pt(thisClustering_basic.inclusive_jets(20.0));    
+				out_jets_basic = sorted_by_pt(thisClustering_basic->inclusive_jets(20.0));    
+    }
+    stopTimer(tClustering);
+    const fastjet::Selector& noGhosts = mNoGhosts;
 
-        // define groomers
-    fastjet::Filter trimmer( fastjet::Filter(fastjet::JetDefinition(fastjet::kt_algorithm, 0.2), fastjet::SelectorPtFractionMin(0.03)));
-    fastjet::Filter filter( fastjet::Filter(fastjet::JetDefinition(fastjet::cambridge_algorithm, 0.3), fastjet::SelectorNHardest(3)));
-    fastjet::Pruner pruner(fastjet::cambridge_algorithm, 0.1, 0.5);
-    
-    std::vector<fastjet::Transformer const *> transformers;
-    transformers.push_back(&trimmer);
-    transformers.push_back(&filter);
-    transformers.push_back(&pruner);
-    
-        // define n-subjettiness
-//    NsubParameters paraNsub = NsubParameters(mNsubjettinessKappa, mJetRadius);   
-//    Nsubjettiness routine(nsub_kt_axes, paraNsub);
-//    Nsubjettiness routine(nsub_1pass_from_kt_axes, paraNsub);
-    
-        // Defining Nsubjettiness parameters
-    double beta = mNsubjettinessKappa; // power for angular dependence, e.g. beta = 1 --> linear k-means, beta = 2 --> quadratic/classic k-means
-    double R0 = mJetRadius; // Characteristic jet radius for normalization	      
-    double Rcut = mJetRadius; // maximum R particles can be from axis to be included in jet	      
-    
-//    fastjet::Nsubjettiness nSub1KT(1, Njettiness::kt_axes, beta, R0, Rcut);
+        // groomers and n-subjettiness, see the constructor
+    const std::vector<fastjet::Transformer*>& transformers = mTransformers;
+    const fastjet::NsubjettinessBatch& nSubKT = *mNsubKT;
+    std::vector<double>& taus_kt = mTausKT;
+    std::vector<double>& taus_onepass = mTausOnepass;
 
         // -----------------------------------------------
         // -----------------------------------------------
@@ -582,10 +634,15 @@ void ewk::GroomedJetFiller::fill(const edm::Event& iEvent) {
 
     for (unsigned j = 0; j < out_jets.size()&&int(j)<NUM_JET_MAX; j++) {
         
+            // constituents of the ghost-free jet
+        std::vector<fastjet::PseudoJet>& basic_constituents = mBasicConstituents;
+        basic_constituents = basicClustering ? 
+            out_jets_basic.at(j).constituents() : noGhosts(out_jets.at(j).constituents());
+        
         if (mSaveConstituents && j==0){
-            if (out_jets_basic.at(j).constituents().size() >= 100) nconstituents0 = 100;
-            else nconstituents0 = (int) out_jets_basic.at(j).constituents().size();
-            std::vector<fastjet::PseudoJet> cur_constituents = sorted_by_pt(out_jets_basic.at(j).constituents());
+            if (basic_constituents.size() >= 100) nconstituents0 = 100;
+            else nconstituents0 = (int) basic_constituents.size();
+            std::vector<fastjet::PseudoJet> cur_constituents = sorted_by_pt(basic_constituents);
             for (int aa = 0; aa < nconstituents0; aa++){        
                 constituents0_eta[aa] = cur_constituents.at(aa).eta();
                 constituents0_phi[aa] = cur_constituents.at(aa).phi();                
@@ -607,19 +664,17 @@ void ewk::GroomedJetFiller::fill(const edm::Event& iEvent) {
         jeteta[j] = jet_corr.Eta();
         jetphi[j] = jet_corr.Phi();
         jete[j]   = jet_corr.Energy();
-        jetconstituents[j] = out_jets_basic.at(j).constituents().size();
+        jetconstituents[j] = basic_constituents.size();
         
             // pruning, trimming, filtering  -------------
+        startTimer(tGrooming);
         int transctr = 0;
-        for ( std::vector<fastjet::Transformer const *>::const_iterator 
+        for ( std::vector<fastjet::Transformer*>::const_iterator 
              itransf = transformers.begin(), itransfEnd = transformers.end(); 
              itransf != itransfEnd; ++itransf ) {  
             
-            fastjet::PseudoJet transformedJet = out_jets.at(j);
-            transformedJet = (**itransf)(transformedJet);
-
-            fastjet::PseudoJet transformedJet_basic = out_jets_basic.at(j);
-            transformedJet_basic = (**itransf)(transformedJet_basic);
+            if (!mCompute[cTrimming + transctr]) { transctr++; continue; }
+            fastjet::PseudoJet transformedJet = (**itransf)(out_jets.at(j));
 
             
             if (transctr == 0){ // trimmed
@@ -655,18 +710,35 @@ void ewk::GroomedJetFiller::fill(const edm::Event& iEvent) {
                 jete_pr[j]   = jet_pr_corr.Energy();
                 jetarea_pr[j] = transformedJet.area();          
                 
-                fastjet::Nsubjettiness nSub1KT_pr(1, Njettiness::onepass_kt_axes, beta, R0, Rcut);
-                fastjet::Nsubjettiness nSub2KT_pr(2, Njettiness::onepass_kt_axes, beta, R0, Rcut);                
-                fastjet::Nsubjettiness nSub3KT_pr(3, Njettiness::onepass_kt_axes, beta, R0, Rcut);                
-                fastjet::Nsubjettiness nSub4KT_pr(4, Njettiness::onepass_kt_axes, beta, R0, Rcut);                
-                tau1_pr[j] = nSub1KT_pr(transformedJet);
-                tau2_pr[j] = nSub2KT_pr(transformedJet);
-                tau3_pr[j] = nSub3KT_pr(transformedJet);
-                tau4_pr[j] = nSub4KT_pr(transformedJet);
-                tau2tau1_pr[j] = tau2_pr[j]/tau1_pr[j];                
+                if (mCompute[cPrunedNsubjettiness]){
+                    nSubKT.result(transformedJet, 0, &taus_onepass);
+                    tau1_pr[j] = taus_onepass[0];
+                    tau2_pr[j] = taus_onepass[1];
+                    tau3_pr[j] = taus_onepass[2];
+                    tau4_pr[j] = taus_onepass[3];
+                    tau2tau1_pr[j] = tau2_pr[j]/tau1_pr[j];                
+                }
+                if (!mCompute[cPrunedSubjets]) { transctr++; continue; }
+                
+                    // subjets of the ghost-free pruned jet; without the ghost-free clustering,
+                    // the surviving real constituents of the ghosted pruned jet are the same
+                    // and are reclustered as in the pruner, which repeats its real merges
+                std::auto_ptr<fastjet::ClusterSequence> prunedClustering;
+                fastjet::PseudoJet transformedJet_basic;
+                std::vector<fastjet::PseudoJet> constituents_pr;
+                if (basicClustering){
+                    transformedJet_basic = (**itransf)(out_jets_basic.at(j));
+                    constituents_pr = transformedJet_basic.constituents();
+                }
+                else{
+                    constituents_pr = noGhosts(transformedJet.constituents());
+                    std::sort(constituents_pr.begin(), constituents_pr.end(), lessUserIndex);
+                    prunedClustering.reset( new fastjet::ClusterSequence(constituents_pr, mPrunedSubjetDef) );
+                    transformedJet_basic = sorted_by_pt(prunedClustering->inclusive_jets(0.0)).at(0);
+                }
                 
                     //decompose into requested number of subjets:
-                if (transformedJet_basic.constituents().size() > 1){
+                if (constituents_pr.size() > 1){
                     int nsubjetstokeep = 2;
                     std::vector<fastjet::PseudoJet> subjets = transformedJet_basic.associated_cluster_sequence()->exclusive_subjets(transformedJet_basic,nsubjetstokeep);    
                     
@@ -693,9 +765,9 @@ void ewk::GroomedJetFiller::fill(const edm::Event& iEvent) {
                 
                     // pruned tests
                 if (mSaveConstituents && j==0){
-                    if (transformedJet_basic.constituents().size() >= 100) nconstituents0pr = 100;
-                    else nconstituents0pr = (int) transformedJet_basic.constituents().size();
-                    std::vector<fastjet::PseudoJet> cur_constituentspr = sorted_by_pt(transformedJet_basic.constituents());
+                    if (constituents_pr.size() >= 100) nconstituents0pr = 100;
+                    else nconstituents0pr = (int) constituents_pr.size();
+                    std::vector<fastjet::PseudoJet> cur_constituentspr = sorted_by_pt(constituents_pr);
                     for (int aa = 0; aa < nconstituents0pr; aa++){        
                         constituents0pr_eta[aa] = cur_constituentspr.at(aa).eta();
                         constituents0pr_phi[aa] = cur_constituentspr.at(aa).phi();                
@@ -706,6 +778,7 @@ void ewk::GroomedJetFiller::fill(const edm::Event& iEvent) {
             else{ std::cout << "error in number of transformers" << std::endl;}                    
             transctr++;
         }        
+        stopTimer(tGrooming);
         
        //std::cout<< "Beging the n-subjettiness computation" << endl; 
             // n-subjettiness  -------------
@@ -714,123 +787,123 @@ void ewk::GroomedJetFiller::fill(const edm::Event& iEvent) {
 //        tau3[j] = routine.getTau(3, out_jets.at(j).constituents());
 //        tau4[j] = routine.getTau(4, out_jets.at(j).constituents());
 //        tau2tau1[j] = tau2[j]/tau1[j];
-//        fastjet::Nsubjettiness nSub1KT(1, Njettiness::kt_axes, beta, R0, Rcut);
-        fastjet::Nsubjettiness nSub1KT(1, Njettiness::onepass_kt_axes, beta, R0, Rcut);
-        fastjet::Nsubjettiness nSub2KT(2, Njettiness::onepass_kt_axes, beta, R0, Rcut);
-        fastjet::Nsubjettiness nSub3KT(3, Njettiness::onepass_kt_axes, beta, R0, Rcut);
-        fastjet::Nsubjettiness nSub4KT(4, Njettiness::onepass_kt_axes, beta, R0, Rcut);
-        tau1[j] = nSub1KT(out_jets.at(j));
-        tau2[j] = nSub2KT(out_jets.at(j));
-        tau3[j] = nSub3KT(out_jets.at(j));
-        tau4[j] = nSub4KT(out_jets.at(j));
-        tau2tau1[j] = tau2[j]/tau1[j];
+        startTimer(tNsubjettiness);
+        if (mCompute[cNsubjettiness] || mCompute[cNsubjettinessExkT])
+            nSubKT.result(out_jets.at(j), mCompute[cNsubjettinessExkT] ? &taus_kt : 0, 
+                          mCompute[cNsubjettiness] ? &taus_onepass : 0);
+        stopTimer(tNsubjettiness);
+        if (mCompute[cNsubjettiness]){
+            tau1[j] = taus_onepass[0];
+            tau2[j] = taus_onepass[1];
+            tau3[j] = taus_onepass[2];
+            tau4[j] = taus_onepass[3];
+            tau2tau1[j] = tau2[j]/tau1[j];
+        }
         
-        fastjet::Nsubjettiness nSub1xKT(1, Njettiness::kt_axes, beta, R0, Rcut);
-        fastjet::Nsubjettiness nSub2xKT(2, Njettiness::kt_axes, beta, R0, Rcut);
-        fastjet::Nsubjettiness nSub3xKT(3, Njettiness::kt_axes, beta, R0, Rcut);        
-        fastjet::Nsubjettiness nSub4xKT(4, Njettiness::kt_axes, beta, R0, Rcut);        
-        tau1_exkT[j] = nSub1xKT(out_jets.at(j));
-        tau2_exkT[j] = nSub2xKT(out_jets.at(j));
-        tau3_exkT[j] = nSub3xKT(out_jets.at(j));
-        tau4_exkT[j] = nSub4xKT(out_jets.at(j));
-        tau2tau1_exkT[j] = tau2_exkT[j]/tau1_exkT[j];
+        if (mCompute[cNsubjettinessExkT]){
+            tau1_exkT[j] = taus_kt[0];
+            tau2_exkT[j] = taus_kt[1];
+            tau3_exkT[j] = taus_kt[2];
+            tau4_exkT[j] = taus_kt[3];
+            tau2tau1_exkT[j] = tau2_exkT[j]/tau1_exkT[j];
+        }
 
         
        //std::cout<< "End the n-subjettiness computation" << endl;
             // cores computation  -------------
         //std::cout<< "Beging the core computation" << endl;
-        std::vector<fastjet::PseudoJet> constits = thisClustering.constituents(out_jets.at(j));
-        for (int kk = 0; kk < 11; ++kk){
-            double coreCtr = (double) kk;    
-            if (coreCtr < mJetRadius*10.){
-                float tmpm = 0, tmppt = 0;
-                computeCore( constits, coreCtr/10., tmpm, tmppt );
+        startTimer(tCores);
+        if (mCompute[cCores] || mCompute[cPlanarflow]){
+            std::vector<fastjet::PseudoJet>& constits = mConstits;
+            constits = thisClustering.constituents(out_jets.at(j));
+                // C/A is nested in R: one clustering gives the leading jet for
+                // all radii, R = 0.0 ... 1.0 (cores) and 0.1 ... 1.1 (planar flow)
+            const std::vector<double>& scanRadii = mScanRadii;
+            std::vector<fastjet::PseudoJet>& scanJets = mScanJets;
+            std::vector< std::vector<fastjet::PseudoJet> >& scanConstits = mScanConstits;
+                // the leading jets are needed for the cores, their constituents for the C/A planar flow
+            const bool planarflowCA = mCompute[cPlanarflow] && mJetAlgo == "CA";
+            if (mCompute[cCores] || planarflowCA)
+                computeRadiusScan( constits, scanRadii, scanJets, planarflowCA ? &scanConstits : 0 );
+            for (unsigned int kk = 0; mCompute[cCores] && kk < scanRadii.size() && kk < 11; ++kk){
+                float tmpm = scanJets[kk].m(), tmppt = scanJets[kk].pt();
                 if (tmpm > 0) rcores[kk][j] = tmpm/out_jets.at(j).m();
                 if (tmppt > 0) ptcores[kk][j] = tmppt/out_jets.at(j).pt();
             }
+            //std::cout<< "Ending the core computation" << endl;
+
+            //std::cout<< "Beging the planarflow computation" << endl;
+
+            //planarflow computation
+            for (unsigned int kk = 1; mCompute[cPlanarflow] && kk < scanRadii.size(); ++kk){
+                float tmppflow = 0;
+                if (mJetAlgo == "CA") computePlanarflow(scanConstits[kk],out_jets.at(j),tmppflow);
+                else {
+                        // anti-kt is not nested in R, recluster for each radius
+                    fastjet::JetDefinition jetDef_rplanarflow(fastjet::antikt_algorithm,scanRadii[kk]);
+                    fastjet::ClusterSequence pflowClustering(constits, jetDef_rplanarflow);
+                    std::vector<fastjet::PseudoJet> pflow_jets = sorted_by_pt(pflowClustering.inclusive_jets(0.0));
+                    computePlanarflow(pflowClustering.constituents(pflow_jets.at(0)),out_jets.at(j),tmppflow);
+                }
+                planarflow[kk-1][j] = tmppflow;
+            }
         }
-        //std::cout<< "Ending the core computation" << endl;
-
-        //std::cout<< "Beging the planarflow computation" << endl;
-
-        //planarflow computation
-        for (int kk = 0; kk < 11; ++kk){
-           double coreCtr = (double) (kk + 1);
-           if (coreCtr < mJetRadius*10.){
-               float tmppflow = 0;
-               computePlanarflow(constits,coreCtr/10.,out_jets.at(j),mJetAlgo,tmppflow);
-               planarflow[kk][j] = tmppflow;
-           }
-        }
+        stopTimer(tCores);
         
         //std::cout<< "Ending the planarflow computation" << endl;
 
             // qjets computation  -------------
-        if ((mDoQJets)&&(j == 0)){ // do qjets only for the hardest jet in the event!
-            double zcut(0.1), dcut_fctr(0.5), exp_min(0.), exp_max(0.), rigidity(0.1);                
-            QjetsPlugin qjet_plugin(zcut, dcut_fctr, exp_min, exp_max, rigidity);
-            fastjet::JetDefinition qjet_def(&qjet_plugin);
-            vector<fastjet::PseudoJet> constits;
-            unsigned int nqjetconstits = out_jets_basic.at(j).constituents().size();
-            if (nqjetconstits < (unsigned int) mQJetsPreclustering) constits = out_jets_basic.at(j).constituents();
-            else constits = out_jets_basic.at(j).associated_cluster_sequence()->exclusive_subjets_up_to(out_jets_basic.at(j),mQJetsPreclustering);
-            for(unsigned int ii = 0 ; ii < (unsigned int) mQJetsN ; ii++){
-                fastjet::ClusterSequence qjet_seq(constits, qjet_def);
-                vector<fastjet::PseudoJet> inclusive_jets2 = sorted_by_pt(qjet_seq.inclusive_jets(50.0));
-                      if(mJetAlgo == "AK" && fabs(mJetRadius-0.5)<0.001)
- 					   inclusive_jets2 = sorted_by_pt(qjet_seq.inclusive_jets(20.0));
-
-                if (inclusive_jets2.size()>0) {
-                  qjetmass[ii] = inclusive_jets2[0].m();
-                  if (inclusive_jets2[0].constituents().size() > 1){
-                      vector<fastjet::PseudoJet> subjets_qjet = qjet_seq.exclusive_subjets(inclusive_jets2[0],2);
-                      if (subjets_qjet.at(0).m() >= subjets_qjet.at(1).m()){
-                          qjetmassdrop[ii] = (subjets_qjet.at(0).m()/inclusive_jets2[0].m());                        
-                      }
-                      else{
-                          qjetmassdrop[ii] = (subjets_qjet.at(1).m()/inclusive_jets2[0].m());                                    
-                      }
-                  }
-                  else{
-                      qjetmassdrop[ii] = 1.;
-                  }
-                }else{
-                    qjetmassdrop[ii] = 1.;
-                }
-                
+        startTimer(tQjets);
+        if ((mDoQJets)&&(mCompute[cQJets])&&(j == 0)){ // do qjets only for the hardest jet in the event!
+            std::vector<fastjet::PseudoJet>& constits = mQjetConstits;
+            unsigned int nqjetconstits = basic_constituents.size();
+            if (nqjetconstits < (unsigned int) mQJetsPreclustering) constits = basic_constituents;
+            else if (basicClustering)
+                constits = out_jets_basic.at(j).associated_cluster_sequence()->exclusive_subjets_up_to(out_jets_basic.at(j),mQJetsPreclustering);
+            else{
+                    // the ghost-free jet again from its constituents in input order: the same
+                    // merges in the same order, so the same subjets in the same order
+                std::vector<fastjet::PseudoJet> ordered = basic_constituents;
+                std::sort(ordered.begin(), ordered.end(), lessUserIndex);
+                fastjet::ClusterSequence jetClustering(ordered, jetDef);
+                fastjet::PseudoJet basicJet = sorted_by_pt(jetClustering.inclusive_jets(0.0)).at(0);
+                constits = jetClustering.exclusive_subjets_up_to(basicJet, mQJetsPreclustering);
             }
+            
+            computeQjetTrials(constits, iEvent.id());
         }
+        stopTimer(tQjets);
             // jet charge try (?) computation  -------------
-        std::vector< float > pdgIds;
-        for (unsigned ii = 0; ii < out_jets_basic.at(j).constituents().size(); ii++){
-            for (unsigned jj = 0; jj < FJparticles.size(); jj++){
-//                std::cout << ii << ", " << jj << ": " << FJparticles.at(jj).pt() << ", " << out_jets_basic.at(j).constituents().at(ii).pt() << std::endl;
-                if (FJparticles.at(jj).pt() == out_jets_basic.at(j).constituents().at(ii).pt()){
-                  if(!isGenJ) {
-                    if(mJetAlgo == "AK" && fabs(mJetRadius-0.5)<0.001) {
-                          pdgIds.push_back(PF_id_handle_AK5.at(jj));
-                    }else{
-                          pdgIds.push_back(PF_id_handle->at(jj));
-                    }
-                  }else{
-                      //pdgIds.push_back(PF_id_handle_Gen.at(jj));
-                      pdgIds.push_back(charge_handle_Gen.at(jj));
-                  }
-                  break;
+        startTimer(tChargeECF);
+        if (mCompute[cJetCharge]){
+                // constituents carry the index of their input particle in user_index
+            std::vector< float >& pdgIds = mPdgIds;
+            pdgIds.clear();
+            for (unsigned ii = 0; ii < basic_constituents.size(); ii++){
+                int jj = basic_constituents[ii].user_index();
+                if(!isGenJ) {
+                    pdgIds.push_back(inputs.pdgIds.at(jj));
+                }else{
+                    //pdgIds.push_back(inputs.pdgIds.at(jj));
+                    pdgIds.push_back(inputs.charges.at(jj));
                 }
             }
+            const float kappas[4] = { (float) mJetChargeKappa, 0.5, 0.7, 1.0 };
+            float charges[4];
+            computeJetCharge( basic_constituents, pdgIds, out_jets_basic.at(j).pt(), kappas, charges, 4 );
+            jetcharge[j] = charges[0];
+            jetcharge_k05[j] = charges[1];
+            jetcharge_k07[j] = charges[2];
+            jetcharge_k10[j] = charges[3];        
         }
-        jetcharge[j] = computeJetCharge( out_jets_basic.at(j).constituents(), pdgIds, out_jets_basic.at(j).pt(), mJetChargeKappa );
-        jetcharge_k05[j] = computeJetCharge( out_jets_basic.at(j).constituents(), pdgIds, out_jets_basic.at(j).pt(), 0.5 );
-        jetcharge_k07[j] = computeJetCharge( out_jets_basic.at(j).constituents(), pdgIds, out_jets_basic.at(j).pt(), 0.7 );
-        jetcharge_k10[j] = computeJetCharge( out_jets_basic.at(j).constituents(), pdgIds, out_jets_basic.at(j).pt(), 1.0 );        
         
         // Generalized energy correlator
-        fastjet::JetDefinition jet_def_forECF(fastjet::antikt_algorithm, 2.0);
-        fastjet::ClusterSequence clust_seq_forECF(out_jets_basic.at(j).constituents(), jet_def_forECF);
-        vector<fastjet::PseudoJet> incluisve_jets_forECF = clust_seq_forECF.inclusive_jets(0);
-        fastjet::GeneralizedEnergyCorrelatorRatio C2beta(2,1.7,fastjet::pT_R); // beta = 1.7
-        jetGeneralizedECF[j] = C2beta(incluisve_jets_forECF[0]);
+        if (mCompute[cGeneralizedECF]){
+            fastjet::ClusterSequence clust_seq_forECF(basic_constituents, mECFJetDef);
+            vector<fastjet::PseudoJet> incluisve_jets_forECF = clust_seq_forECF.inclusive_jets(0);
+            jetGeneralizedECF[j] = (*mECFRatio)(incluisve_jets_forECF[0]);
+        }
+        stopTimer(tChargeECF);
         
     }
 
@@ -838,6 +911,92 @@ void ewk::GroomedJetFiller::fill(const edm::Event& iEvent) {
 
 
 
+unsigned int ewk::GroomedJetFiller::qjetsSeed(const edm::EventID& eventId, unsigned int trial) const{
+    
+        // mix run, lumi, event and trial number (splitmix64 finaliser)
+    unsigned long long h = eventId.run();
+    h = h*0x9E3779B97F4A7C15ULL + eventId.luminosityBlock();
+    h = h*0x9E3779B97F4A7C15ULL + eventId.event();
+    h = h*0x9E3779B97F4A7C15ULL + trial;
+    h ^= h >> 30; h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27; h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return (unsigned int) h;
+}
+
+
+
+void ewk::GroomedJetFiller::computeQjetTrials(const std::vector<fastjet::PseudoJet>& constits, const edm::EventID& eventId){
+    
+        // the threads share plain copies (momentum and user_index) of the constituents:
+        // fastjet 3.0 does not count the references to a cluster-sequence structure atomically
+    std::vector<fastjet::PseudoJet>& inputs = mQjetInputs;
+    inputs.clear();
+    for (unsigned int i = 0; i < constits.size(); ++i){
+        fastjet::PseudoJet input(constits[i].px(), constits[i].py(), constits[i].pz(), constits[i].E());
+        input.set_user_index(constits[i].user_index());
+        inputs.push_back(input);
+    }
+    
+        // every trial has its own seed and its own slot of qjetmass and qjetmassdrop,
+        // so the result does not depend on the number of threads
+    const unsigned int nThreads = mQjetPlugins.size();
+    std::vector<std::exception_ptr> errors(nThreads);
+    if (nThreads == 1) computeQjetTrialRange(&inputs, &eventId, 0, 1, &errors[0]);
+    else{
+        std::vector<std::thread> workers;
+        for (unsigned int t = 0; t < nThreads; t++)
+            workers.push_back( std::thread(&ewk::GroomedJetFiller::computeQjetTrialRange, this, &inputs, &eventId, t, nThreads, &errors[t]) );
+        for (unsigned int t = 0; t < workers.size(); t++) workers[t].join();
+    }
+    for (unsigned int t = 0; t < nThreads; t++)
+        if (errors[t] != std::exception_ptr()) std::rethrow_exception(errors[t]);
+}
+
+
+
+void ewk::GroomedJetFiller::computeQjetTrialRange(const std::vector<fastjet::PseudoJet>* inputs, const edm::EventID* eventId, 
+                                                  unsigned int first, unsigned int stride, std::exception_ptr* error){
+    
+        // trials first, first+stride, ... all run on the plugin of this thread;
+        // an exception is passed on to computeQjetTrials
+    try{
+        QjetsPlugin& qjet_plugin = *mQjetPlugins.at(first);
+        for(unsigned int ii = first ; ii < (unsigned int) mQJetsN ; ii += stride){
+            qjet_plugin.SetRandSeed( qjetsSeed(*eventId, ii) );
+            fastjet::JetDefinition qjet_def(&qjet_plugin);
+            fastjet::ClusterSequence qjet_seq(*inputs, qjet_def);
+            vector<fastjet::PseudoJet> inclusive_jets2 = sorted_by_pt(qjet_seq.inclusive_jets(50.0));
+                  if(mJetAlgo == "AK" && fabs(mJetRadius-0.5)<0.001)
+     				   inclusive_jets2 = sorted_by_pt(qjet_seq.inclusive_jets(20.0));
+
+            if (inclusive_jets2.size()>0) {
+              qjetmass[ii] = inclusive_jets2[0].m();
+              if (inclusive_jets2[0].constituents().size() > 1){
+                  vector<fastjet::PseudoJet> subjets_qjet = qjet_seq.exclusive_subjets(inclusive_jets2[0],2);
+                  if (subjets_qjet.at(0).m() >= subjets_qjet.at(1).m()){
+                      qjetmassdrop[ii] = (subjets_qjet.at(0).m()/inclusive_jets2[0].m());                        
+                  }
+                  else{
+                      qjetmassdrop[ii] = (subjets_qjet.at(1).m()/inclusive_jets2[0].m());                                    
+                  }
+              }
+              else{
+                  qjetmassdrop[ii] = 1.;
+              }
+            }else{
+                qjetmassdrop[ii] = 1.;
+            }
+        
+        }
+    }
+    catch(...){
+        *error = std::current_exception();
+    }
+}
+
+
+
 double ewk::GroomedJetFiller::getJEC(double curJetEta, 
                                      double curJetPt, 
                                      double curJetE, 
@@ -875,34 +1034,53 @@ TLorentzVector ewk::GroomedJetFiller::getCorrectedJet(fastjet::PseudoJet& jet, d
     return jet_corr;
 }
 
-void ewk::GroomedJetFiller::computeCore( std::vector<fastjet::PseudoJet> constits, double Rval, float &m_core, float &pt_core ){
-    
-    fastjet::JetDefinition jetDef_rcore(fastjet::cambridge_algorithm, Rval);
-    fastjet::ClusterSequence thisClustering(constits, jetDef_rcore);
-    
-    std::vector<fastjet::PseudoJet> out_jets = sorted_by_pt(thisClustering.inclusive_jets(0.0));
-    m_core = out_jets.at(0).m();
-    pt_core = out_jets.at(0).pt();
-    
-}
-
-void ewk::GroomedJetFiller::computePlanarflow(std::vector<fastjet::PseudoJet> constits, double Rval, fastjet::PseudoJet jet,std::string mJetAlgo, float &planarflow){
+void ewk::GroomedJetFiller::computeRadiusScan( const std::vector<fastjet::PseudoJet>& constits, const std::vector<double>& radii,
+                                                std::vector<fastjet::PseudoJet>& leadingJets, 
+                                                std::vector< std::vector<fastjet::PseudoJet> >* leadingConstits ){
+
+    leadingJets.assign(radii.size(), fastjet::PseudoJet(0.,0.,0.,0.));
+    if (leadingConstits) leadingConstits->assign(radii.size(), std::vector<fastjet::PseudoJet>());
+    if (radii.empty() || constits.empty()) return;
+
+        // C/A at radius R performs exactly the merges of any larger radius
+        // with dR < R, in the same order: replay the history of the largest
+        // one and read off the inclusive jets each time a radius is crossed
+    fastjet::JetDefinition jetDef_scan(fastjet::cambridge_algorithm, std::max(radii.back(), 0.1));
+    fastjet::ClusterSequence scanClustering(constits, jetDef_scan);
+    const std::vector<fastjet::ClusterSequence::history_element>& history = scanClustering.history();
+    const std::vector<fastjet::PseudoJet>& jets = scanClustering.jets();
+
+    std::vector<char> active(history.size(), 0);
+    for (unsigned int i = 0; i < constits.size(); i++) active[i] = 1;
+
+    unsigned int iR = 0;
+    for (unsigned int i = constits.size(); i <= history.size() && iR < radii.size(); i++){
+        double dR = std::numeric_limits<double>::max();
+        if (i < history.size() && history[i].parent2 != fastjet::ClusterSequence::BeamJet)
+            dR = sqrt(jets[history[history[i].parent1].jetp_index].plain_distance(jets[history[history[i].parent2].jetp_index]));
+
+        for (; iR < radii.size() && dR >= radii[iR]; iR++){
+                // leading inclusive jet at this radius
+            int leading = -1;
+            for (unsigned int h = 0; h < i; h++)
+                if (active[h] && (leading < 0 || jets[history[h].jetp_index].perp2() > jets[history[leading].jetp_index].perp2())) leading = h;
+            leadingJets[iR] = jets[history[leading].jetp_index];
+            if (leadingConstits) (*leadingConstits)[iR] = scanClustering.constituents(leadingJets[iR]);
+        }
 
-   fastjet::JetDefinition jetDef_rplanarflow(fastjet::cambridge_algorithm,Rval);
-   if (mJetAlgo == "AK") jetDef_rplanarflow.set_jet_algorithm( fastjet::antikt_algorithm );
-   else if (mJetAlgo == "CA") jetDef_rplanarflow.set_jet_algorithm( fastjet::cambridge_algorithm );
-   else throw cms::Exception("GroomedJetFiller") << " unknown jet algorithm " << std::endl;
-   fastjet::ClusterSequence thisClustering(constits, jetDef_rplanarflow);
+        if (i == history.size() || history[i].parent2 == fastjet::ClusterSequence::BeamJet) continue;
+        active[history[i].parent1] = 0;
+        active[history[i].parent2] = 0;
+        active[i] = 1;
+    }
+}
 
-   //reclustering jets
-   std::vector<fastjet::PseudoJet> out_jets = sorted_by_pt(thisClustering.inclusive_jets(0.0));
+void ewk::GroomedJetFiller::computePlanarflow(const std::vector<fastjet::PseudoJet>& subconstits, const fastjet::PseudoJet& jet, float &planarflow){
 
    //leading sub jet constits mass not equal Zero
    float mJ = jet.m();
    if(mJ != 0)
    {
-      std::vector<fastjet::PseudoJet> subconstits = thisClustering.constituents(out_jets.at(0)); 
-
       TLorentzVector jetp4;
       //jetp4.SetPxPyPzE(out_jets.at(0).px(),out_jets.at(0).py(),out_jets.at(0).pz(),out_jets.at(0).e());
       jetp4.SetPxPyPzE(jet.px(),jet.py(),jet.pz(),jet.e());
@@ -941,21 +1119,21 @@ void ewk::GroomedJetFiller::computePlanarflow(std::vector<fastjet::PseudoJet> co
    }
 }
 
-float ewk::GroomedJetFiller::computeJetCharge( std::vector<fastjet::PseudoJet> constits, std::vector<float> pdgIds, float PTjet, float kappa ){
+void ewk::GroomedJetFiller::computeJetCharge( const std::vector<fastjet::PseudoJet>& constits, const std::vector<float>& pdgIds, float PTjet, 
+                                               const float* kappas, float* charges, unsigned int nKappas ){
 
-   float val = 0.;
+   for (unsigned int k = 0; k < nKappas; k++) charges[k] = 0.;
    for (unsigned int i = 0; i < pdgIds.size(); i++){
       float qq ;
       if(isGenJ) {
-          //qq = charge_handle_Gen.at(i);
           qq = pdgIds.at(i); // in the GEN case, charges are directly stored
       }else{
          qq = getPdgIdCharge( pdgIds.at(i) );
       }
-      val += qq*pow(constits.at(i).pt(),kappa);
+      double pt = constits.at(i).pt();
+      for (unsigned int k = 0; k < nKappas; k++) charges[k] += qq*pow(pt,kappas[k]);
    }
-   val /= pow(PTjet,kappa);
-   return val;
+   for (unsigned int k = 0; k < nKappas; k++) charges[k] /= pow(PTjet,kappas[k]);
 
 }
 
@@ -0,0 +1,154 @@
+/*****************************************************************************
+ * Project: CMS detector at the CERN
+ *
+ * Package: ElectroWeakAnalysis/VPlusJets
+ *
+ *
+ * Authors:
+ *   Nhan V Tran, Fermilab - kalanand@fnal.gov
+ *   Kalanand Mishra, Fermilab - kalanand@fnal.gov
+ *
+ * Description:
+ *   Per-event cache of the fastjet inputs of the GroomedJetFillers.
+ * History:
+ *
+ *
+ * Copyright (C) 2012 FNAL
+ *****************************************************************************/
+
+
+    // user include files
+#include "ElectroWeakAnalysis/VPlusJets/interface/GroomedJetParticleCache.h"
+
+#include "DataFormats/VertexReco/interface/Vertex.h"
+#include "DataFormats/VertexReco/interface/VertexFwd.h"
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidate.h"
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidateFwd.h"
+#include "DataFormats/HepMCCandidate/interface/GenParticle.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+
+ewk::GroomedJetParticleCache::GroomedJetParticleCache(const edm::ParameterSet& iConfig)
+{
+        //// --- fastjet rho label -------
+    JetsFor_rho =  iConfig.getParameter<std::string>("srcJetsforRho") ;
+
+        //// --- primary vertex -------
+    if(  iConfig.existsAs<edm::InputTag>("srcPrimaryVertex") )
+        mPrimaryVertex = iConfig.getParameter<edm::InputTag>("srcPrimaryVertex");
+    else mPrimaryVertex =  edm::InputTag("offlinePrimaryVertices");
+
+    rhoVal_ = -99.;
+    nPV_ = 0.;
+}
+
+
+
+void ewk::GroomedJetParticleCache::addInput(const std::string& label, InputType type)
+{
+    std::map<std::string, InputType>::const_iterator it = inputs_.find(label);
+    if (it != inputs_.end() && it->second != type)
+        throw cms::Exception("GroomedJetParticleCache") << " input " << label
+                                                        << " requested with two different types " << std::endl;
+    inputs_[label] = type;
+    particles_[label];
+}
+
+
+
+void ewk::GroomedJetParticleCache::fill(const edm::Event& iEvent)
+{
+        // ------ get rho --------
+    rhoVal_ = -99.;
+    edm::Handle<double> rho;
+    const edm::InputTag eventrho(JetsFor_rho, "rho");
+    iEvent.getByLabel(eventrho,rho);
+    rhoVal_ = *rho;
+
+        // ------ get nPV: primary/secondary vertices------
+    double nPVval = 0;
+    edm::Handle <edm::View<reco::Vertex> > recVtxs;
+    iEvent.getByLabel( mPrimaryVertex, recVtxs);
+    for(unsigned int ind=0;ind<recVtxs->size();ind++){
+        if (!((*recVtxs)[ind].isFake()) && ((*recVtxs)[ind].ndof()>=4)
+            && (fabs((*recVtxs)[ind].z())<=24.0) &&
+            ((*recVtxs)[ind].position().Rho()<=2.0) ) {
+            nPVval += 1;
+        }
+    }
+    nPV_ = nPVval;
+
+        // ------ convert every registered collection once ------
+    for (std::map<std::string, InputType>::const_iterator it = inputs_.begin(); it != inputs_.end(); ++it){
+
+        const std::string& label = it->first;
+        Particles& out = particles_[label];
+        out.particles.clear();
+        out.pdgIds.clear();
+        out.charges.clear();
+
+        if (it->second == GenParticles){
+            edm::Handle<reco::GenParticleRefVector> genParticles;
+            iEvent.getByLabel(label, genParticles);
+            out.particles.reserve(genParticles->size());
+            out.pdgIds.reserve(genParticles->size());
+            out.charges.reserve(genParticles->size());
+            for(size_t i = 0; i < genParticles->size(); ++ i) {
+                const reco::GenParticle&    P = *((*genParticles)[i]);
+                out.particles.push_back( fastjet::PseudoJet( P.px(),
+                                                             P.py(),
+                                                             P.pz(),
+                                                             P.energy() ) );
+                out.particles.back().set_user_index(i);
+                out.pdgIds.push_back(P.pdgId());
+                out.charges.push_back(P.charge());
+            }
+        }
+        else if (it->second == PFCandidates){
+            edm::Handle< reco::PFCandidateCollection > pfCandidates;
+            iEvent.getByLabel(label,"pfCandidates",pfCandidates);
+            out.particles.reserve(pfCandidates->size());
+            out.pdgIds.reserve(pfCandidates->size());
+            for( reco::PFCandidateCollection::const_iterator ci  = pfCandidates->begin(); ci!=pfCandidates->end(); ++ci)  {
+                out.particles.push_back( fastjet::PseudoJet( ci->px(),
+                                                             ci->py(),
+                                                             ci->pz(),
+                                                             ci->energy() ) );
+                out.particles.back().set_user_index(out.particles.size()-1);
+                out.pdgIds.push_back(ci->translateTypeToPdgId(ci->particleId()));
+            }
+        }
+        else{
+            edm::Handle< std::vector<float> > PF_px_handle;
+            edm::Handle< std::vector<float> > PF_py_handle;
+            edm::Handle< std::vector<float> > PF_pz_handle;
+            edm::Handle< std::vector<float> > PF_en_handle;
+            edm::Handle< std::vector<float> > PF_id_handle;
+            iEvent.getByLabel( label, "px" ,    PF_px_handle);
+            iEvent.getByLabel( label, "py" ,    PF_py_handle);
+            iEvent.getByLabel( label, "pz" ,    PF_pz_handle);
+            iEvent.getByLabel( label, "energy", PF_en_handle);
+            iEvent.getByLabel( label, "pdgId", PF_id_handle);
+            out.particles.reserve(PF_px_handle->size());
+            for (unsigned i = 0; i < PF_px_handle->size() ; i++){
+                out.particles.push_back( fastjet::PseudoJet( PF_px_handle->at(i),
+                                                             PF_py_handle->at(i),
+                                                             PF_pz_handle->at(i),
+                                                             PF_en_handle->at(i) ) );
+                out.particles.back().set_user_index(i);
+            }
+            out.pdgIds = *PF_id_handle;
+        }
+    }
+}
+
+
+
+const ewk::GroomedJetParticleCache::Particles&
+ewk::GroomedJetParticleCache::particles(const std::string& label) const
+{
+    std::map<std::string, Particles>::const_iterator it = particles_.find(label);
+    if (it == particles_.end())
+        throw cms::Exception("GroomedJetParticleCache") << " input " << label << " was never registered " << std::endl;
+    return it->second;
+}
@@ -0,0 +1,60 @@
+/*****************************************************************************
+ * Project: CMS detector at the CERN
+ *
+ * Package: ElectroWeakAnalysis/VPlusJets
+ *
+ *
+ * Authors:
+ *   A. Marini, K. Kousouris,  K. Theofilatos
+ *
+ * Description:
+ *   Jet-object overlap removal shared by the jet cleaners.
+ * History:
+ *
+ *****************************************************************************/
+
+#include "ElectroWeakAnalysis/VPlusJets/interface/JetOverlapCleaner.h"
+#include "DataFormats/Math/interface/deltaPhi.h"
+
+
+ewk::JetOverlapCleaner::JetOverlapCleaner(double deltaRMin, unsigned int maxPairsForPairwise)
+  : deltaRMin_(deltaRMin), deltaR2Min_(deltaRMin*deltaRMin),
+    maxPairsForPairwise_(maxPairsForPairwise), nClean_(0), objectGrid_(deltaRMin)
+{}
+
+
+
+void ewk::JetOverlapCleaner::removeOverlaps()
+{
+  const unsigned int nObj = objEtas_.size();
+  if (nObj == 0) return;
+
+  // for small jet x object counts the grid costs more to build than it saves
+  if (nObj*nClean_ <= maxPairsForPairwise_) {
+    for (unsigned int iJet = 0; iJet < jetEtas_.size(); iJet++) {
+      if (!clean_[iJet]) continue;
+      const double eta = jetEtas_[iJet], phi = jetPhis_[iJet];
+      for (unsigned int iObj = 0; iObj < nObj; iObj++) {
+        const double dEta = objEtas_[iObj] - eta;
+        if (dEta*dEta >= deltaR2Min_) continue;
+        const double dPhi = reco::deltaPhi(objPhis_[iObj], phi);
+        if (dEta*dEta + dPhi*dPhi < deltaR2Min_) {
+          clean_[iJet] = 0;
+          nClean_--;
+          break;
+        }
+      }
+    }
+    return;
+  }
+
+  // one cone query per still-clean jet on the objects binned in eta-phi
+  objectGrid_.fill(objEtas_, objPhis_);
+  for (unsigned int iJet = 0; iJet < jetEtas_.size(); iJet++) {
+    if (!clean_[iJet]) continue;
+    if (objectGrid_.anyInCone(jetEtas_[iJet], jetPhis_[iJet], deltaRMin_)) {
+      clean_[iJet] = 0;
+      nClean_--;
+    }
+  }
+}
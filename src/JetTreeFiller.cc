@@ -73,10 +73,30 @@ const float BTAG_DISCRIM_DEFAULT=-999.;
   // ---- Quark Gluon Likelihood
   qglikeli = new QGLikelihoodCalculator();  
 
+  // ---- per-jet timing of the PF/QGL part
+  name_ = name;
+  mTimeJets = false;
+  if( iConfig.existsAs<bool>("timeJetFilling"))
+    mTimeJets = iConfig.getParameter<bool>("timeJetFilling");
+  jetTimer_.Reset();
+  nTimedJets_ = 0;
+
   if( !(tree==0) ) SetBranches();
 }
 
 
+
+ ewk::JetTreeFiller::~JetTreeFiller()
+{
+  if( mTimeJets && nTimedJets_>0 ) {
+    std::cout << name_ << ": PF energy fractions + QGL for " << nTimedJets_ << " jets, " 
+	      << 1.e6*jetTimer_.CpuTime()/nTimedJets_ << " us cpu, " 
+	      << 1.e6*jetTimer_.RealTime()/nTimedJets_ << " us real per jet" << std::endl;
+  }
+  delete qglikeli;
+}
+
+
  void ewk::JetTreeFiller::SetBranches()
 {
   // Declare jet branches
@@ -584,25 +604,28 @@ void ewk::JetTreeFiller::fill(const edm::Event& iEvent){
       // ------- fill energy fractions --------------------	
     const std::type_info & type = typeid(*jet);
     if ( type == typeid(reco::PFJet) || type == typeid(pat::Jet)) {
+      if(mTimeJets) jetTimer_.Start(kFALSE);
 
-      // PFJet specific quantities
-      std::vector<reco::PFCandidatePtr> pfCandidates;
+      // PFJet specific quantities, read in place from the jet in the event;
+      // the constituents are copied one by one into the kept buffer
+      pfCandidates_.clear();
       if(type == typeid(reco::PFJet)) {
-	reco::PFJet pfjet  = static_cast<const reco::PFJet &>(*jet);
+	const reco::PFJet& pfjet  = static_cast<const reco::PFJet &>(*jet);
 	fillEnergyFractionsPFjets(pfjet, iJet);
-        pfCandidates = pfjet.getPFConstituents();
+        for (unsigned int i = 0; i < pfjet.nConstituents(); ++i) pfCandidates_.push_back(pfjet.getPFConstituent(i));
       }
       if(type == typeid(pat::Jet)) {
-	pat::Jet pfjet  = static_cast<const pat::Jet &>(*jet);
+	const pat::Jet& pfjet  = static_cast<const pat::Jet &>(*jet);
 	if(pfjet.isPFJet()) {
 	  fillEnergyFractionsPFjets(pfjet, iJet);
-	  pfCandidates = pfjet.getPFConstituents();
+	  for (unsigned int i = 0; i < pfjet.nConstituents(); ++i) pfCandidates_.push_back(pfjet.getPFConstituent(i));
 	}
       }
 	
       // ------- Compute pt_D and Quark Gluon Likelihood		 
-      fillQGLH(iJet, fastjet_rho, pfCandidates);
+      fillQGLH(iJet, fastjet_rho, pfCandidates_);
 
+      if(mTimeJets) { jetTimer_.Stop(); nTimedJets_++; }
     }// close PF jets loop
 
   }// close jets iteration loop
@@ -820,33 +843,37 @@ void ewk::JetTreeFiller::fillEnergyFractionsPFjets(const pat::Jet&, int);
 //////--------- Compute Quark-Gluon likelihood ---
 
 void ewk::JetTreeFiller::fillQGLH(int iJet, float fastjet_rho, 
-				  std::vector<reco::PFCandidatePtr> pfCandidates) 
+				  const std::vector<reco::PFCandidatePtr>& pfCandidates) 
 {
   // ------- Compute pt_D and Quark Gluon Likelihood		  
   float sumPt_cands=0.;
   float sumPt2_cands=0.;
   float rms_cands=0.;
-			
-  typedef std::vector<reco::PFCandidatePtr>::const_iterator IC;
 
+  // candidate kinematics into contiguous arrays, one dereference per candidate
+  candPt_.clear();
+  candEta_.clear();
+  candPhi_.clear();
+  typedef std::vector<reco::PFCandidatePtr>::const_iterator IC;
   for (IC jt = pfCandidates.begin(); // If pfCandidates has no constituents then the loop simply won't execute
        jt != pfCandidates.end(); jt++) { // and so no segmentation fault should occur
-    const reco::PFCandidatePtr pfCandPtr = *jt;
+    const reco::PFCandidatePtr& pfCandPtr = *jt;
     if ( !(pfCandPtr.isNonnull() && pfCandPtr.isAvailable()) ) continue;
-			  
-    // reco::PFCandidate::ParticleType id = (*jt)->particleId();
-    // Convert particle momentum to normal TLorentzVector, wrong type :(
-    math::XYZTLorentzVectorD const& p4t = pfCandPtr->p4();
-
-    TLorentzVector p4(p4t.px(), p4t.py(), p4t.pz(), p4t.energy());
-    TLorentzVector jetp4;
-    jetp4.SetPtEtaPhiE(Pt[iJet], Eta[iJet], Phi[iJet], E[iJet]);
-    if(p4.Pt()!=0){
-      sumPt_cands += p4.Pt();
-      sumPt2_cands += (p4.Pt()*p4.Pt());
-      float deltaR = jetp4.DeltaR(p4);
-      rms_cands += (p4.Pt()*p4.Pt()*deltaR*deltaR);
-    }
+    const reco::PFCandidate& cand = *pfCandPtr;
+    if(cand.pt()==0) continue;
+    candPt_.push_back(cand.pt());
+    candEta_.push_back(cand.eta());
+    candPhi_.push_back(cand.phi());
+  }
+
+  const double jetEta = Eta[iJet];
+  const double jetPhi = Phi[iJet];
+  for (unsigned int i = 0; i < candPt_.size(); i++) {
+    const double pt = candPt_[i];
+    sumPt_cands += pt;
+    sumPt2_cands += (pt*pt);
+    float deltaR = radius( jetEta, jetPhi, candEta_[i], candPhi_[i] );
+    rms_cands += (pt*pt*deltaR*deltaR);
   }			  
   PFsumPtCands[iJet]  = sumPt_cands;
   PFsumPt2Cands[iJet] = sumPt2_cands;
@@ -1159,10 +1186,7 @@ void ewk::JetTreeFiller::computeLeptonAndNu4Vectors(const reco::Candidate* Vboso
 {
   const reco::Candidate* m0 = Vboson->daughter(0);
   const reco::Candidate* m1 = Vboson->daughter(1);
-  TLorentzVector p4MET;
-  TLorentzVector p4lepton;
-  METzCalculator* metz = new METzCalculator();
-  if (LeptonType_=="electron") metz->SetLeptonType("electron");
+  const double leptonMass = METzCalculator::LeptonMass(LeptonType_=="electron" ? "electron" : "muon");
   double nupz;
 
 
@@ -1170,26 +1194,18 @@ void ewk::JetTreeFiller::computeLeptonAndNu4Vectors(const reco::Candidate* Vboso
   if( m0->isElectron() || m0->isMuon() ) 
     p4lepton1.SetPxPyPzE(m0->px(), m0->py(), m0->pz(), m0->energy());
   else {
-    p4MET.SetPxPyPzE(met.px(), met.py(), met.pz(), met.energy());
-    p4lepton.SetPxPyPzE(m1->px(), m1->py(), m1->pz(), m1->energy());
-    metz->SetMET(p4MET);
-    metz->SetLepton(p4lepton);
-    nupz = metz->Calculate();
+    nupz = METzCalculator::Solve(m1->px(), m1->py(), m1->pz(), m1->energy(),
+				 met.px(), met.py(), met.energy(), leptonMass).pz;
     p4lepton1.SetPxPyPzE( m0->px(), m0->py(), nupz, sqrt(m0->px()*m0->px()+m0->py()*m0->py()+nupz*nupz) );
   }
 
   if( m1->isElectron() || m1->isMuon() ) 
     p4lepton2.SetPxPyPzE(m1->px(), m1->py(), m1->pz(), m1->energy());
   else {
-    p4MET.SetPxPyPzE(met.px(), met.py(), met.pz(), met.energy());
-    p4lepton.SetPxPyPzE(m0->px(), m0->py(), m0->pz(), m0->energy());
-    metz->SetMET(p4MET);
-    metz->SetLepton(p4lepton);
-    nupz = metz->Calculate();
+    nupz = METzCalculator::Solve(m0->px(), m0->py(), m0->pz(), m0->energy(),
+				 met.px(), met.py(), met.energy(), leptonMass).pz;
     p4lepton2.SetPxPyPzE( m1->px(), m1->py(), nupz, sqrt(m1->px()*m1->px()+m1->py()*m1->py()+nupz*nupz) );
   }
-
-  delete metz;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -650,7 +650,6 @@ void ewk::MCTreeFiller::fill(const edm::Event& iEvent)
   const reco::Candidate *Met=NULL;
 
   const reco::Candidate *t=NULL;
-  const reco::Candidate *tbar=NULL;
   const reco::Candidate *aH=NULL;
 
 //  const reco::Candidate *ab=NULL;
@@ -674,19 +673,19 @@ void ewk::MCTreeFiller::fill(const edm::Event& iEvent)
   const reco::Candidate *EWKTagQuark1=NULL;
   const reco::Candidate *EWKTagQuark2=NULL;
 
-  // Vector Bosons Info 
-  for(size_t i = 0; i < nGen; ++ i) {
+  // one pass over the record: status-3 buckets and mother/daughter links
+  genIndex_.fill(genParticles);
+  const std::vector<int>& status3 = genIndex_.status3();
 
-     V = &((*genParticles)[i]);
+  // Vector Bosons Info 
+  for(size_t i = 0; i < status3.size(); ++ i) {
 
     // The vector boson must have stutus==3  
-    if( !(abs(V->status())==3) ) continue;
+    V = &genIndex_.at(status3[i]);
 
     if(V->pdgId()==22)Photon_pt_gen = V->pt();
 
-    size_t ndau = 0;
-
-    if(!(V==NULL)) ndau = V->numberOfDaughters();
+    size_t ndau = V->numberOfDaughters();
     // The vector boson must decay to leptons
 
     if(ndau<1) continue;
@@ -706,136 +705,79 @@ void ewk::MCTreeFiller::fill(const edm::Event& iEvent)
         if ( abs(d->pdgId())==(pdgIdDau_+1) )  lepton2  = d;
       } 
     } // end ndaughter loop
-  }// end genParticles loop
+  }// end status-3 loop
 
 
 
 //tth gen information
 
- for(size_t i = 0; i < nGen; ++ i) {
-    aH = &((*genParticles)[i]);
-    t = &((*genParticles)[i]);
-    tbar = &((*genParticles)[i]);
+  const std::vector<int>& higgses = genIndex_.status3(25);
+  const std::vector<int>& tops = genIndex_.status3(6);
+
 // asociated higgs
-    if( ((abs(aH->status())==3) && (abs(aH->pdgId())==25) )){
-      //        std::cout<<"tth    "<<aH->pdgId()<<std::endl;
-       size_t aHndau =0;
-    if(!(aH==NULL)) aHndau = aH->numberOfDaughters();
-//        std::cout<<"bbar    "<<aHndau<<std::endl;
+  for(size_t i = 0; i < higgses.size(); ++ i) {
+    aH = &genIndex_.at(higgses[i]);
+    size_t aHndau = aH->numberOfDaughters();
     if(aHndau<1) continue;
     for(size_t k =0; k< aHndau-1; k++){
 //loop over higgs daughter
       const reco::Candidate *g = aH->daughter( k );
-      if( !(g==NULL) && (g->pdgId()==5) ) {Hb=g;
-	//         std::cout<<"h decay b    "<<g->pdgId()<<std::endl;
-}
-      else if (!(g==NULL) && (g->pdgId()==-5)) {Hbbar=g;
-	//        std::cout<<" h decay bbar    "<<g->pdgId()<<std::endl;
-}
-}
-}
-
-//associated top 
+      if( !(g==NULL) && (g->pdgId()==5) ) Hb=g;
+      else if (!(g==NULL) && (g->pdgId()==-5)) Hbbar=g;
+    }
+  }
 
-    if( ((abs(t->status())==3) && (t->pdgId()==6) )){
-       std::cout<<" associated top   "<<t->pdgId()<<std::endl;
-       size_t atndau =0;
-    if(!(t==NULL)) atndau = t->numberOfDaughters();
-//        std::cout<<"bbar    "<<aHndau<<std::endl;
+// associated top and anti top, in record order
+  for(size_t i = 0; i < tops.size(); ++ i) {
+    t = &genIndex_.at(tops[i]);
+    const int sign = (t->pdgId() > 0) ? 1 : -1;
+    if(sign>0) std::cout<<" associated top   "<<t->pdgId()<<std::endl;
+    else std::cout<<" associated anti top    "<<t->pdgId()<<std::endl;
+    size_t atndau = t->numberOfDaughters();
     if(atndau<1) continue;
     for(size_t k =0; k< atndau-1; k++){
-//loop over associated top daughter
-      const reco::Candidate *p = t->daughter( k );
-      if (!(p==NULL) && (abs(p->pdgId())==5)) tb=p;
-      else if( !(p==NULL) && (p->pdgId()==24) ) {
-	//        std::cout<<"W    "<<p->pdgId()<<std::endl;
-        size_t tWndau =0;
-           tWndau = p->numberOfDaughters();
-           if(tWndau<1) continue;
-           for (size_t l =0; l<tWndau-1; l++){
+//loop over (anti) top daughter
+      const reco::Candidate *q = t->daughter( k );
+      if(q==NULL) continue;
+      if( sign>0 && abs(q->pdgId())==5 ) { tb=q; continue; }
+      if( sign<0 && q->pdgId()==-5 ) { tbbar=q; continue; }
+      if( q->pdgId()!=sign*24 ) continue;
+      size_t tWndau = q->numberOfDaughters();
+      if(tWndau<1) continue;
+      for (size_t l =0; l<tWndau-1; l++){
 //loop over tW daughter
-           const reco::Candidate *g = p->daughter( l );
-        //std::cout<<" dau    "<<e->numberOfDaughters()<<std::endl;
-	   //  std::cout<<" dau of tW   "<<g->pdgId()<<std::endl;
-           if( !(g==NULL)&& (abs(g->pdgId())<=4)){
-           tParton1 =g->daughter(0);
-           tParton2 =g->daughter(1);}
-           else if (!(g==NULL) && ((abs(g->pdgId())==12) ||(abs(g->pdgId())==14))) tMet =g;
-           else if (!(g==NULL) && ((abs(g->pdgId())==11) ||(abs(g->pdgId())==13))) tLepton =g;
-
-			}// loop over dau of tW
-
-		} // W condidate
-	} // loop over top daughter
-}// associated top
-
-// associated anti top
-
-    if( ((abs(tbar->status())==3) && (tbar->pdgId()==-6) )){
-	std::cout<<" associated anti top    "<<tbar->pdgId()<<std::endl;
-        size_t atbarndau =0;
-      	if(!(tbar==NULL)) atbarndau = tbar->numberOfDaughters();
- 	//std::cout<<"bbar    "<<aHndau<<std::endl;
-    	if(atbarndau<1) continue;
-   	 for(size_t k =0; k< atbarndau-1; k++){
-	//loop over associated anti top daughter
-      	const reco::Candidate *q = tbar->daughter( k );
-      	if (!(q==NULL) && (q->pdgId()==-5)){ tbbar=q;
-	  //       std::cout<<" anti top bbar    "<<q->pdgId()<<std::endl;
-        }
-      	else if( !(q==NULL) && (q->pdgId()==-24) ) {
-	  //        std::cout<<" anti top W    "<<q->pdgId()<<std::endl;
-       	size_t tbarWndau =0;
-        tbarWndau = q->numberOfDaughters();
-           if(tbarWndau<1) continue;
-           for (size_t l =0; l<tbarWndau-1; l++){
-//loop over tbarW daughter
-           const reco::Candidate *h = q->daughter( l );
-        //std::cout<<" dau    "<<e->numberOfDaughters()<<std::endl;
-	   //       std::cout<<" dau of anti top W    "<<h->pdgId()<<std::endl;
-           if( !(h==NULL)&& (abs(h->pdgId())<=4)){
-           tParton1 =h->daughter(0);
-           tParton2 =h->daughter(1);}
-           else if (!(h==NULL) && ((abs(h->pdgId())==12) ||(abs(h->pdgId())==14))) tMet =h;
-           else if (!(h==NULL) && ((abs(h->pdgId())==11) ||(abs(h->pdgId())==13))) tLepton =h;
-
- 				} //loop over dau of tbar W 	
-			}	// W conditate loop	
-
-		} // loop over tbar daughter
-	}// anti top
-
-
-}// gen Particles loop
+        const reco::Candidate *g = q->daughter( l );
+        if( !(g==NULL)&& (abs(g->pdgId())<=4)){
+          tParton1 =g->daughter(0);
+          tParton2 =g->daughter(1);}
+        else if (!(g==NULL) && ((abs(g->pdgId())==12) ||(abs(g->pdgId())==14))) tMet =g;
+        else if (!(g==NULL) && ((abs(g->pdgId())==11) ||(abs(g->pdgId())==13))) tLepton =g;
+      }// loop over dau of tW
+    } // loop over top daughter
+  }// associated (anti) top
 
 // tth info ends
 
 
 
 //;;;;;;;;;;;;;;;;;;;;;;;;;;;my stuff;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
-  for(size_t i = 0; i < nGen; ++ i) {
-    H = &((*genParticles)[i]);
-    if( !((abs(H->status())==3) && (abs(H->pdgId())==25) ))continue;
+  std::vector<int> siblings;
+  for(size_t i = 0; i < higgses.size(); ++ i) {
+    const reco::Candidate *h = &genIndex_.at(higgses[i]);
   //Higgs must decay to W
-//	std::cout<<"hhhhhhhhhhhh    "<<H->pdgId()<<std::endl;
-    size_t Hndau =0;
-    size_t Wndau =0;
-    if(!(H==NULL)) Hndau = H->numberOfDaughters();
-//        std::cout<<"WWWW    "<<Hndau<<std::endl;
+    size_t Hndau = h->numberOfDaughters();
     if(Hndau<1) continue;
+    H = h;
     for(size_t k =0; k< Hndau-1; k++){
 //loop over higgs daughter
       const reco::Candidate *e = H->daughter( k );
       if( !(e==NULL) && (abs(e->pdgId())==24) ) {
 //if higgs dau is W
-  //      std::cout<<"WWWW    "<<e->pdgId()<<std::endl;
-           Wndau = e->numberOfDaughters();
+           size_t Wndau = e->numberOfDaughters();
            if(Wndau<1) continue;
            for (size_t l =0; l<Wndau-1; l++){
 //loop over W daughter
            const reco::Candidate *f = e->daughter( l );
-        //std::cout<<" dau    "<<e->numberOfDaughters()<<std::endl;
-    //    std::cout<<" dau    "<<f->pdgId()<<std::endl;
            if( !(f==NULL)&& (abs(f->pdgId())<=4)){ 
            Parton1 =e->daughter(0);
            Parton2 =e->daughter(1);}
@@ -845,91 +787,61 @@ void ewk::MCTreeFiller::fill(const edm::Event& iEvent)
 	}	
 	} 
 
-    // save tag quark information for vbf case in HWW topology 
-    int counter = 0;
-    if(H!=NULL){
-      for(reco::GenParticleCollection::const_iterator p = genParticles -> begin();p != genParticles -> end(); ++p,counter++){
-
-      const reco::Candidate* pCurrent = &(*p);
-  
-      if(counter == 7) TagQuark1 = pCurrent;
-      if(counter == 8) TagQuark2 = pCurrent;
-
-     }
-    }
-      
-
+    // save tag quark information for vbf case in HWW topology: 
+    // the hard-process partons produced together with the Higgs
+    genIndex_.status3PartonSiblings(higgses[i], siblings);
+    TagQuark1 = (siblings.size() > 1) ? &genIndex_.at(siblings[0]) : NULL;
+    TagQuark2 = (siblings.size() > 1) ? &genIndex_.at(siblings[1]) : NULL;
+  }
 
   ////////// Higgs boson quantities //////////////
-if(H==NULL) return;
-
-  H_mass = H->mass();
-  H_Eta = H->eta();   
-  H_Phi = H->phi();
-  H_Vx = H->vx();
-  H_Vy = H->vy();
-  H_Vz = H->vz();
-  H_Y  = H->rapidity();
-  H_px = H->px();
-  H_py = H->py();
-  H_pz = H->pz();
-  H_E  = H->energy();
-  H_Pt = H->pt();
-  H_Et = H->et();
-  H_Id = H->pdgId();
-
-} //nGen loop end
+  if(H!=NULL) {
+    H_mass = H->mass();
+    H_Eta = H->eta();   
+    H_Phi = H->phi();
+    H_Vx = H->vx();
+    H_Vy = H->vy();
+    H_Vz = H->vz();
+    H_Y  = H->rapidity();
+    H_px = H->px();
+    H_py = H->py();
+    H_pz = H->pz();
+    H_E  = H->energy();
+    H_Pt = H->pt();
+    H_Et = H->et();
+    H_Id = H->pdgId();
+  }
 
 //#################################EWKW2Jets###################################
-for(size_t i = 0; i < nGen; ++ i) {
-   EWKW = &((*genParticles)[i]);
-   //Generated W from Matrix Element
-   if( !((abs(EWKW->status())==3) && (abs(EWKW->pdgId())==24) ))continue;
-
-   if( EWKW!=NULL && (abs(EWKW->status())==3) && (abs(EWKW->pdgId())==24) ) {
-      EWKW_Charge          = EWKW->charge();
-      EWKW_Vx              = EWKW->vx();
-      EWKW_Vy              = EWKW->vy();
-      EWKW_Vz              = EWKW->vz();
-      EWKW_Y               = EWKW->rapidity();
-      EWKW_Theta           = EWKW->theta();
-      EWKW_Eta             = EWKW->eta();
-      EWKW_Phi             = EWKW->phi();
-      EWKW_E               = EWKW->energy();
-      EWKW_px              = EWKW->px();
-      EWKW_py              = EWKW->py();
-      EWKW_pz              = EWKW->pz();
-      EWKW_Pt              = EWKW->pt();
-      EWKW_Et              = EWKW->et(); 
-      EWKW_Id              = EWKW->pdgId();
-
-      int tmp1 = i + 2;
-      int tmp2 = i + 1;
-      EWKTagQuark1 = &((*genParticles)[tmp1]);
-      EWKTagQuark2 = &((*genParticles)[tmp2]);
-
-   }
-
-} //nGen loop end
-
-for(size_t i = 0; i < nGen; ++ i) {
-   const reco::Candidate* tmp = &((*genParticles)[i]);
-   //Generated W from Matrix Element
-   if( !((abs(tmp->status())==3) && (abs(tmp->pdgId())==24) )) continue;
-
-   if((abs(tmp->status())==3) && (abs(tmp->pdgId())==24) )
-   {
-      for(reco::GenParticleCollection::const_iterator p = genParticles -> begin();p != genParticles -> end(); ++p){
-
-         const reco::Candidate* pCurrent = &(*p);
-
-         if((pCurrent->status())==3 && (abs(pCurrent->pdgId())<=5 || abs(pCurrent->pdgId()) == 21) )
-         {
-            nParton_Winclusive++;
-         }
-      }
-   }
-} //nGen loop end
+  const std::vector<int>& ws = genIndex_.status3(24);
+  for(size_t i = 0; i < ws.size(); ++ i) {
+    //Generated W from Matrix Element
+    EWKW = &genIndex_.at(ws[i]);
+
+    EWKW_Charge          = EWKW->charge();
+    EWKW_Vx              = EWKW->vx();
+    EWKW_Vy              = EWKW->vy();
+    EWKW_Vz              = EWKW->vz();
+    EWKW_Y               = EWKW->rapidity();
+    EWKW_Theta           = EWKW->theta();
+    EWKW_Eta             = EWKW->eta();
+    EWKW_Phi             = EWKW->phi();
+    EWKW_E               = EWKW->energy();
+    EWKW_px              = EWKW->px();
+    EWKW_py              = EWKW->py();
+    EWKW_pz              = EWKW->pz();
+    EWKW_Pt              = EWKW->pt();
+    EWKW_Et              = EWKW->et(); 
+    EWKW_Id              = EWKW->pdgId();
+
+    // the two hard-process partons produced with the W, later one first
+    genIndex_.status3PartonSiblings(ws[i], siblings);
+    EWKTagQuark1 = (siblings.size() > 1) ? &genIndex_.at(siblings[1]) : NULL;
+    EWKTagQuark2 = (siblings.size() > 1) ? &genIndex_.at(siblings[0]) : NULL;
+  } //status-3 W loop end
+
+  // every status-3 W counts all the status-3 partons of the event
+  nParton_Winclusive += (int) ws.size() * genIndex_.nStatus3Partons();
 
 //std::cout << "nPartons: " << nParton_Winclusive << std::endl;
 
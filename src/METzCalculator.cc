@@ -1,5 +1,6 @@
 #include "ElectroWeakAnalysis/VPlusJets/interface/METzCalculator.h"
 #include "TMath.h"
+#include <cmath>
 
 /// constructor
 METzCalculator::METzCalculator() {
@@ -18,16 +19,28 @@ METzCalculator::~METzCalculator() {
 double
 METzCalculator::Calculate(int type) {
 
+	Solution sol = Solve(lepton_.Px(), lepton_.Py(), lepton_.Pz(), lepton_.E(),
+			     MET_.Px(), MET_.Py(), MET_.E(), leptonMass_, type);
+	isComplex_ = sol.isComplex;
+	otherSol_ = sol.otherSol;
+	if (sol.isComplex) {
+		newPtneutrino1_ = sol.ptNeutrino1;
+		newPtneutrino2_ = sol.ptNeutrino2;
+	}
+	return sol.pz;
+}
+
+METzCalculator::Solution
+METzCalculator::Solve(double pxmu, double pymu, double pzmu, double emu,
+		      double pxnu, double pynu, double pnu,
+		      double M_mu, int type) {
+
 	double M_W  = 80.4;
-        double M_mu =  leptonMass_;
-        double emu = lepton_.E();
-        double pxmu = lepton_.Px();
-        double pymu = lepton_.Py();
-        double pzmu = lepton_.Pz();
-        double pxnu = MET_.Px();
-        double pynu = MET_.Py();
         double pznu = 0.;
-	otherSol_ = 0.;
+	Solution sol;
+	sol.otherSol = 0.;
+	sol.ptNeutrino1 = -1;
+	sol.ptNeutrino2 = -1;
 		
         double a = M_W*M_W - M_mu*M_mu + 2.0*pxmu*pxnu + 2.0*pymu*pynu;
         double A = 4.0*(emu*emu - pzmu*pzmu);
@@ -37,16 +50,14 @@ METzCalculator::Calculate(int type) {
         double tmproot = B*B - 4.0*A*C;
 
         if (tmproot<0) {
-                isComplex_= true;
+                sol.isComplex= true;
                 pznu = - B/(2*A); // take real part of complex roots
-		otherSol_ = pznu;
+		sol.otherSol = pznu;
 
 		// recalculate the neutrino pT
 		// solve quadratic eq. discriminator = 0 for pT of nu
-		double pnu = MET_.E();
 		double Delta = (M_W*M_W - M_mu*M_mu);
 		double alpha = (pxmu*pxnu/pnu + pymu*pynu/pnu);
-		double ptmu = TMath::Sqrt( pxmu*pxmu + pymu*pymu); ptmu = TMath::Sqrt( pxmu*pxmu + pymu*pymu);
 		double ptnu = TMath::Sqrt( pxnu*pxnu + pynu*pynu); // old
 		double AA = 4.*pzmu*pzmu - 4*emu*emu + 4*alpha*alpha;
 		double BB = 4.*alpha*Delta;
@@ -56,12 +67,12 @@ METzCalculator::Calculate(int type) {
 		double tmpsolpt1 = (-BB + TMath::Sqrt(tmpdisc))/(2.0*AA);
 		double tmpsolpt2 = (-BB - TMath::Sqrt(tmpdisc))/(2.0*AA);
 		
-		if ( fabs( tmpsolpt1 - ptnu ) < fabs( tmpsolpt2 - ptnu) ) { newPtneutrino1_ = tmpsolpt1; newPtneutrino2_ = tmpsolpt2;}
-		else { newPtneutrino1_ = tmpsolpt2; newPtneutrino2_ = tmpsolpt1; }
+		if ( fabs( tmpsolpt1 - ptnu ) < fabs( tmpsolpt2 - ptnu) ) { sol.ptNeutrino1 = tmpsolpt1; sol.ptNeutrino2 = tmpsolpt2;}
+		else { sol.ptNeutrino1 = tmpsolpt2; sol.ptNeutrino2 = tmpsolpt1; }
 		
 	}
         else {
-			isComplex_ = false;
+			sol.isComplex = false;
 			double tmpsol1 = (-B + TMath::Sqrt(tmproot))/(2.0*A);
 			double tmpsol2 = (-B - TMath::Sqrt(tmproot))/(2.0*A);
 
@@ -69,23 +80,23 @@ METzCalculator::Calculate(int type) {
 			
 			if (type == 0 ) {
 				// two real roots, pick the one closest to pz of muon
-			  if (TMath::Abs(tmpsol2-pzmu) < TMath::Abs(tmpsol1-pzmu)) { pznu = tmpsol2; otherSol_ = tmpsol1;}
-			  else { pznu = tmpsol1; otherSol_ = tmpsol2; } 
+			  if (TMath::Abs(tmpsol2-pzmu) < TMath::Abs(tmpsol1-pzmu)) { pznu = tmpsol2; sol.otherSol = tmpsol1;}
+			  else { pznu = tmpsol1; sol.otherSol = tmpsol2; } 
 				// if pznu is > 300 pick the most central root
 				if ( pznu > 300. ) {
-				  if (TMath::Abs(tmpsol1)<TMath::Abs(tmpsol2) ) { pznu = tmpsol1; otherSol_ = tmpsol2; }
-				  else { pznu = tmpsol2; otherSol_ = tmpsol1; }
+				  if (TMath::Abs(tmpsol1)<TMath::Abs(tmpsol2) ) { pznu = tmpsol1; sol.otherSol = tmpsol2; }
+				  else { pznu = tmpsol2; sol.otherSol = tmpsol1; }
 				}
 			}
 			if (type == 1 ) {
 				// two real roots, pick the one closest to pz of muon
-			  if (TMath::Abs(tmpsol2-pzmu) < TMath::Abs(tmpsol1-pzmu)) { pznu = tmpsol2; otherSol_ = tmpsol1; }
-			  else {pznu = tmpsol1; otherSol_ = tmpsol2; }
+			  if (TMath::Abs(tmpsol2-pzmu) < TMath::Abs(tmpsol1-pzmu)) { pznu = tmpsol2; sol.otherSol = tmpsol1; }
+			  else {pznu = tmpsol1; sol.otherSol = tmpsol2; }
 			}
 			if (type == 2 ) {
 				// pick the most central root.
-			  if (TMath::Abs(tmpsol1)<TMath::Abs(tmpsol2) ) { pznu = tmpsol1; otherSol_ = tmpsol2; }
-			  else { pznu = tmpsol2; otherSol_ = tmpsol1; }
+			  if (TMath::Abs(tmpsol1)<TMath::Abs(tmpsol2) ) { pznu = tmpsol1; sol.otherSol = tmpsol2; }
+			  else { pznu = tmpsol2; sol.otherSol = tmpsol1; }
 			}
 			if (type == 3 ) {
 				// pick the largest value of the cosine
@@ -100,8 +111,8 @@ METzCalculator::Calculate(int type) {
 				double costhcm1 = TMath::Sqrt(1. - sinthcm1*sinthcm1);
 				double costhcm2 = TMath::Sqrt(1. - sinthcm2*sinthcm2);
 
-				if ( costhcm1 > costhcm2 ) { pznu = tmpsol1; otherSol_ = tmpsol2; }
-				else { pznu = tmpsol2;otherSol_ = tmpsol1; }
+				if ( costhcm1 > costhcm2 ) { pznu = tmpsol1; sol.otherSol = tmpsol2; }
+				else { pznu = tmpsol2;sol.otherSol = tmpsol1; }
 			}
 		
         }
@@ -109,5 +120,6 @@ METzCalculator::Calculate(int type) {
         //Particle neutrino;
         //neutrino.setP4( LorentzVector(pxnu, pynu, pznu, TMath::Sqrt(pxnu*pxnu + pynu*pynu + pznu*pznu ))) ;
 
-        return pznu;
+	sol.pz = pznu;
+        return sol;
 }
@@ -0,0 +1,70 @@
+//  Batched N-subjettiness on top of the Njettiness package (Version 0.4.1).
+//
+//  Computes tau_1 ... tau_Nmax of one jet in a single call, for exclusive kT
+//  axes and for one-pass minimised axes seeded from them.  The kT clustering
+//  of the constituents is done once and its history is shared by all N and
+//  by both axis modes; the results are identical to those of the individual
+//  fastjet::Nsubjettiness(N, Njettiness::kt_axes / onepass_kt_axes, ...) calls.
+
+
+#ifndef __NSUBJETTINESSBATCH_HH__
+#define __NSUBJETTINESSBATCH_HH__
+
+#include "Njettiness.hh"
+
+#include "fastjet/PseudoJet.hh"
+#include "fastjet/ClusterSequence.hh"
+
+#include <vector>
+#include <limits>
+
+
+FASTJET_BEGIN_NAMESPACE      // defined in fastjet/internal/base.hh
+
+class NsubjettinessBatch {
+public:
+
+   NsubjettinessBatch(unsigned Nmax, double beta, double R0, double Rcutoff=std::numeric_limits<double>::max());
+
+   /// fills tau_kt[N-1] and/or tau_onepass[N-1] for N = 1..Nmax,
+   /// measured on the constituents of this jet; either output may be null
+   void result(const PseudoJet& jet, std::vector<double>* tau_kt, std::vector<double>* tau_onepass) const;
+
+private:
+
+   unsigned _Nmax;
+   NsubParameters _paraNsub;
+   KmeansParameters _paraOnepass;
+
+};
+
+inline NsubjettinessBatch::NsubjettinessBatch(unsigned Nmax, double beta, double R0, double Rcutoff)
+  : _Nmax(Nmax), _paraNsub(beta, R0, Rcutoff), _paraOnepass(1,0.0001,1000,0.8)  // as Njettiness for onepass_kt_axes
+{}
+
+inline void NsubjettinessBatch::result(const PseudoJet& jet, std::vector<double>* tau_kt, std::vector<double>* tau_onepass) const
+{
+   if (tau_kt) tau_kt->assign(_Nmax, 0.0);
+   if (tau_onepass) tau_onepass->assign(_Nmax, 0.0);
+
+   std::vector<fastjet::PseudoJet> particles = jet.constituents();
+   if (particles.size() <= 1) return;   // tau_N = 0 whenever there are no more particles than axes
+
+   // same clustering as GetKTAxes(), done once for every N
+   fastjet::JetDefinition jet_def = fastjet::JetDefinition(fastjet::kt_algorithm,M_PI/2.0,fastjet::E_scheme,fastjet::Best);
+   fastjet::ClusterSequence jet_clust_seq(particles, jet_def);
+
+   for (unsigned n = 1; n <= _Nmax && n < particles.size(); ++n) {
+      std::vector<fastjet::PseudoJet> ktAxes = jet_clust_seq.exclusive_jets((int) n);
+      if (tau_kt) (*tau_kt)[n-1] = TauValue(particles, ktAxes, _paraNsub);
+      if (tau_onepass) {
+         std::vector<fastjet::PseudoJet> onepassAxes = GetMinimumAxes(ktAxes, particles, _paraOnepass, _paraNsub);
+         (*tau_onepass)[n-1] = TauValue(particles, onepassAxes, _paraNsub);
+      }
+   }
+}
+
+
+FASTJET_END_NAMESPACE      // defined in fastjet/internal/base.hh
+
+#endif  // __NSUBJETTINESSBATCH_HH__
@@ -107,6 +107,9 @@
 #include "SimDataFormats/GeneratorProducts/interface/GenEventInfoProduct.h"
 #include "SimDataFormats/GeneratorProducts/interface/GenRunInfoProduct.h"
 
+#include "ElectroWeakAnalysis/VPlusJets/interface/VertexTrackMap.h"
+#include "ElectroWeakAnalysis/VPlusJets/interface/EtaPhiGrid.h"
+
 //
 // class declaration
 //
@@ -224,6 +227,11 @@ class PATZJetsExpress : public edm::EDAnalyzer {
       edm::Handle<edm::TriggerResults>   triggerResultsHandle_;
       edm::Handle<trigger::TriggerEvent> triggerEventHandle_;
       HLTConfigProvider hltConfig_;
+      // ---- track -> vertex association of the current event ----------
+      ewk::VertexTrackMap mVtxTrackMap;
+      // ---- pf candidates binned in eta-phi for the lepton isolation ---
+      ewk::EtaPhiGrid mPFCandGrid;
+      std::vector<unsigned int> mConeIndices;
       // ---- configurable parameters -----------------------------------
       bool          mIsMC;
       int           mMinNjets;
@@ -669,6 +677,7 @@ void PATZJetsExpress::analyze(const Event& iEvent, const EventSetup& iSetup)
   edm::Handle<VertexCollection> vertices_;
   iEvent.getByLabel("offlinePrimaryVertices", vertices_);
   const reco::Vertex *primVtx = &(*(vertices_.product()))[0];
+  mVtxTrackMap.fill(*vertices_);
   for(VertexCollection::const_iterator i_vtx = vertices_->begin(); i_vtx != vertices_->end(); ++i_vtx) {  
     if (!i_vtx->isFake() && (fabs(i_vtx->z()) < 24) && (i_vtx->ndof() >= 4)) {
       vtxZ_   ->push_back(i_vtx->z());
@@ -798,13 +807,13 @@ void PATZJetsExpress::analyze(const Event& iEvent, const EventSetup& iSetup)
   // ---- PF isolation for leptons --------------------------------------
   Handle<View<PFCandidate> > pfCandidates;
   iEvent.getByLabel("particleFlow", pfCandidates);
+  // ---- eta-phi grid of the candidates, queried once per lepton -------
+  if (myLeptons.size() > 0) mPFCandGrid.fill(*pfCandidates);
   for(unsigned il=0;il<myLeptons.size();il++) {
     float sumPt(0.0);
-    for(unsigned ipf=0;ipf<pfCandidates->size();ipf++) {
-      float dR = deltaR(myLeptons[il].p4.Eta(),myLeptons[il].p4.Phi(),(*pfCandidates)[ipf].eta(),(*pfCandidates)[ipf].phi());
-      if (dR < 0.3) {
-        sumPt += (*pfCandidates)[ipf].pt();
-      }
+    mPFCandGrid.coneIndices(myLeptons[il].p4.Eta(),myLeptons[il].p4.Phi(),0.3,mConeIndices);
+    for(unsigned ic=0;ic<mConeIndices.size();ic++) {
+      sumPt += (*pfCandidates)[mConeIndices[ic]].pt();
     }
     float isoPF = (sumPt-myLeptons[il].p4.Pt()-(*rho)*0.2827434)/myLeptons[il].p4.Pt();
     myLeptons[il].isoPF = isoPF;
@@ -1062,7 +1071,7 @@ void PATZJetsExpress::analyze(const Event& iEvent, const EventSetup& iSetup)
     float jec  = 1./i_jet->jecFactor(0);
     float unc  = i_jet->userFloat("jecUnc");
     float btag = i_jet->bDiscriminator("combinedSecondaryVertexBJetTags");
-    float beta = i_jet->userFloat("beta");
+    float beta = i_jet->hasUserFloat("beta") ? i_jet->userFloat("beta") : -1.0;
     // ---- keep only jets that pass the tight id -----------------------
     float chf = i_jet->chargedHadronEnergyFraction();
     float nhf = i_jet->neutralHadronEnergyFraction() + i_jet->HFHadronEnergyFraction();
@@ -1075,37 +1084,12 @@ void PATZJetsExpress::analyze(const Event& iEvent, const EventSetup& iSetup)
     if (!id) jetIsIDed = false;
     // ---- jet vertex association --------------------------------------
     // ---- get the vector of tracks ------------------------------------ 
-    //reco::TrackRefVector vTrks(i_jet->getTrackRefs());
-    //float sumTrkPt(0.0),sumTrkPtBeta(0.0),sumTrkPtBetaStar(0.0),beta(-1.0),betaStar(-1.0);
-    // ---- loop over the tracks of the jet -----------------------------
-    /*
-    for(reco::TrackRefVector::const_iterator i_trk = vTrks.begin(); i_trk != vTrks.end(); i_trk++) {
-      sumTrkPt += (*i_trk)->pt();
-      // ---- loop over all vertices ------------------------------------
-      for(unsigned i_vtx = 0;i_vtx < vertices_->size();i_vtx++) {
-        // ---- loop over the tracks associated with the vertex ---------
-        if ((*vertices_)[i_vtx].isFake() || (*vertices_)[i_vtx].ndof() < 4) continue; 
-        for(reco::Vertex::trackRef_iterator i_vtxTrk = (*vertices_)[i_vtx].tracks_begin(); i_vtxTrk != (*vertices_)[i_vtx].tracks_end(); ++i_vtxTrk) {
-          // ---- match the jet track to the track from the vertex ------
-          reco::TrackRef trkRef(i_vtxTrk->castTo<reco::TrackRef>());
-          // ---- check if the tracks match -----------------------------
-          if (trkRef == (*i_trk)) {
-            if (i_vtx == 0) {
-              sumTrkPtBeta += (*i_trk)->pt();
-            }
-            else {
-              sumTrkPtBetaStar += (*i_trk)->pt();
-            }   
-            continue;
-          }
-        }
-      }// vertices loop 
-    }// jet tracks loop
-    if (sumTrkPt > 0) {
-      beta     = sumTrkPtBeta/sumTrkPt;
-      betaStar = sumTrkPtBetaStar/sumTrkPt;
+    // ---- beta is normally embedded by the PAT sequence; otherwise ---
+    // ---- compute it from the associated tracks --------------------
+    if (!i_jet->hasUserFloat("beta")) {
+      float betaStar(-1.0);
+      mVtxTrackMap.betaAndBetaStar(i_jet->associatedTracks(),beta,betaStar);
     }
-    */
     JET aJet; 
     aJet.p4       = jetP4;
     aJet.jec      = jec;
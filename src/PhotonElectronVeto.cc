@@ -0,0 +1,76 @@
+/*****************************************************************************
+ * Project: CMS detector at the CERN
+ *
+ * Package: ElectroWeakAnalysis/VPlusJets
+ *
+ *
+ * Authors:
+ *
+ *   Kalanand Mishra, Fermilab - kalanand@fnal.gov
+ *
+ * Description:
+ *   Conversion-safe electron veto for photons, built once per event.
+ * History:
+ *   
+ *
+ * Copyright (C) 2013 FNAL 
+ *****************************************************************************/
+
+#include "ElectroWeakAnalysis/VPlusJets/interface/PhotonElectronVeto.h"
+
+#include <algorithm>
+
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/BeamSpot/interface/BeamSpot.h"
+#include "DataFormats/EgammaReco/interface/SuperCluster.h"
+#include "DataFormats/EgammaCandidates/interface/GsfElectron.h"
+#include "DataFormats/EgammaCandidates/interface/GsfElectronFwd.h"
+#include "DataFormats/EgammaCandidates/interface/Conversion.h"
+#include "DataFormats/EgammaCandidates/interface/ConversionFwd.h"
+#include "RecoEgamma/EgammaTools/interface/ConversionTools.h"
+
+
+
+void ewk::PhotonElectronVeto::fill(const edm::EventBase& iEvent)
+{
+  edm::Handle<reco::BeamSpot> bsHandle;
+  iEvent.getByLabel(edm::InputTag("offlineBeamSpot"), bsHandle);
+  beamspot_ = bsHandle->position();
+
+  iEvent.getByLabel(edm::InputTag("allConversions"), conversions_);
+  iEvent.getByLabel(edm::InputTag("gsfElectrons"), electrons_);
+
+  // only the superclusters here: the conversion match is left to the
+  // electrons that share a supercluster with a photon
+  electronSCs_.clear();
+  for (unsigned int i = 0; i < electrons_->size(); ++i)
+    electronSCs_.push_back(std::make_pair((*electrons_)[i].superCluster(), i));
+  std::sort(electronSCs_.begin(), electronSCs_.end());
+  prompt_.assign(electrons_->size(), -1);
+}
+
+
+
+bool ewk::PhotonElectronVeto::isPrompt(unsigned int iElectron) const
+{
+  signed char& prompt = prompt_[iElectron];
+  if (prompt < 0) {
+    // the electron part of ConversionTools::hasMatchedPromptElectron
+    const reco::GsfElectron& electron = (*electrons_)[iElectron];
+    prompt = electron.gsfTrack()->trackerExpectedHitsInner().numberOfHits() == 0 &&
+      !ConversionTools::hasMatchedConversion(electron, conversions_, beamspot_);
+  }
+  return prompt;
+}
+
+
+
+bool ewk::PhotonElectronVeto::passElectronVeto(const reco::SuperClusterRef& sc) const
+{
+  if (sc.isNull()) return true;
+  std::vector<std::pair<reco::SuperClusterRef, unsigned int> >::const_iterator it =
+    std::lower_bound(electronSCs_.begin(), electronSCs_.end(), std::make_pair(sc, 0u));
+  for (; it != electronSCs_.end() && it->first == sc; ++it)
+    if (isPrompt(it->second)) return false;
+  return true;
+}
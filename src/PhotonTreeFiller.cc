@@ -25,8 +25,6 @@
 #include "DataFormats/ParticleFlowCandidate/interface/PFCandidate.h"
 #include "DataFormats/ParticleFlowCandidate/interface/PFCandidateFwd.h"
 
-#include "RecoEgamma/EgammaTools/interface/ConversionTools.h"
-
 // Monte Carlo stuff
 
 // Header file
@@ -249,15 +247,8 @@ void ewk::PhotonTreeFiller::fill(const edm::Event& iEvent)
   init();
 
 
-   edm::Handle<reco::BeamSpot> bsHandle;
-   iEvent.getByLabel("offlineBeamSpot", bsHandle);
-   const reco::BeamSpot &beamspot = *bsHandle.product();
-
-   edm::Handle<reco::ConversionCollection> hConversions;
-   iEvent.getByLabel("allConversions", hConversions);
-
-   edm::Handle<reco::GsfElectronCollection> hElectrons;
-   iEvent.getByLabel("gsfElectrons", hElectrons);
+   // prompt electrons for the conversion-safe electron veto
+   electronVeto.fill(iEvent);
 
    // Photons - from reco
     edm::Handle<reco::PhotonCollection> photonH;
@@ -290,7 +281,7 @@ void ewk::PhotonTreeFiller::fill(const edm::Event& iEvent)
 	 if (!myPhotonRef->isEB()&&!myPhotonRef->isEE()) continue;
          if ( myPhotonRef->et()<20.) continue;
 
-	 passElecVeto[NumPhotons] = !ConversionTools::hasMatchedPromptElectron(myPhotonRef->superCluster(), hElectrons, hConversions, beamspot.position());
+	 passElecVeto[NumPhotons] = electronVeto.passElectronVeto(myPhotonRef->superCluster());
          hasPixelSeed[NumPhotons] = myPhotonRef->hasPixelSeed();
 
          Et[NumPhotons] = myPhotonRef->et();
@@ -4,6 +4,8 @@
 #include <vector>
 #include <list>
 #include <algorithm>
+#include <functional>
+#include <random>
 #include "fastjet/JetDefinition.hh"
 #include "fastjet/PseudoJet.hh"
 #include "fastjet/ClusterSequence.hh"
@@ -25,22 +27,39 @@ class JetDistanceCompare{
 class Qjets{
  private:
   double _zcut, _dcut, _dcut_fctr, _exp_min, _exp_max, _rigidity;
-  vector <int> _merged_jets;
-  list <jet_distance> _distances;
+  bool _rand_seed_set;
+  std::mt19937 _rand_engine;
+
+  // all pair distances ever computed, in a contiguous block; a pair stays
+  // in place once its jets are merged
+  vector <jet_distance> _distances;
+  // merged flag for every jet of the cluster sequence
+  vector <char> _merged;
+  // pair distances ordered by dij, for the running minimum (lazy deletion)
+  priority_queue <pair<double,int>, vector<pair<double,int> >, greater<pair<double,int> > > _dmin_queue;
+  // pairs with both jets unmerged, in creation order, and their selection
+  // weights exp(-rigidity*(dij-dmin)/dmin) at the current step
+  vector <int> _live;
+  vector <double> _weights;
 
   double d_ij(const fastjet::PseudoJet& v1, const fastjet::PseudoJet& v2);
   void ComputeDCut(fastjet::ClusterSequence & cs);
 
   double Rand();
   bool Prune(jet_distance& jd,fastjet::ClusterSequence & cs);
-  bool JetsUnmerged(jet_distance& jd);
-  bool JetUnmerged(int num);
+  bool JetsUnmerged(const jet_distance& jd) const;
+  bool JetUnmerged(int num) const;
+  void MergeJet(int num);
+  void AddDistance(int j1, int j2, double dij);
   void ComputeNewDistanceMeasures(fastjet::ClusterSequence & cs, int new_jet);
   void ComputeAllDistances(const vector<fastjet::PseudoJet>& inp);  
   double ComputeMinimumDistance();
   double ComputeNormalization(double dmin);
+  int SelectPair(double rand, double norm) const;
  public:
   Qjets(double zcut, double dcut_fctr, double exp_min, double exp_max, double rigidity);
+  // use a private engine with this seed instead of the global rand()
+  void SetRandSeed(unsigned int seed);
   void Cluster(fastjet::ClusterSequence & cs);
 };
 #endif
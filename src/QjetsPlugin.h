@@ -8,8 +8,13 @@
 class QjetsPlugin: public fastjet::JetDefinition::Plugin{
  private:
   double _zcut, _dcut_fctr, _exp_min, _exp_max, _rigidity;
+  bool _rand_seed_set;
+  unsigned int _rand_seed;
  public:
   QjetsPlugin(double zcut, double dcut_fctr, double exp_min, double exp_max, double rigidity);
+  // every clustering run with this plugin uses its own engine started from
+  // this seed; without a seed the global rand() is used, as before
+  void SetRandSeed(unsigned int seed);
   double R() const;
   string description() const;
   void run_clustering(fastjet::ClusterSequence & cs) const;
@@ -53,6 +53,24 @@ ewk::SnowmassTreeProducer::SnowmassTreeProducer(const edm::ParameterSet iConfig)
   tree_ ( new TTree("tree","tree") )
 {
   mInputJets = iConfig.getParameter<edm::InputTag>("srcJets");
+
+  // maximum number of entries stored per event for each block, 
+  // e.g. collectionCaps = cms.PSet( track = cms.int32(2000) )
+  edm::ParameterSet caps;
+  if( iConfig.existsAs<edm::ParameterSet>("collectionCaps") )
+    caps = iConfig.getParameter<edm::ParameterSet>("collectionCaps");
+  setCap( muons_,            "muon",            caps, 999 );
+  setCap( electrons_,        "electron",        caps, 999 );
+  setCap( jets_,             "jet",             caps, 999 );
+  setCap( photons_,          "photon",          caps, 999 );
+  setCap( tracks_,           "track",           caps, 999 );
+  setCap( gsftracks_,        "gsftrack",        caps, 999 );
+  setCap( superClusters_,    "superCluster",    caps, 999 );
+  setCap( superClusters5x5_, "superCluster5x5", caps, 999 );
+  setCap( caloTowers_,       "caloTower",       caps, 999 );
+  setCap( taus_,             "tau",             caps, 999 );
+  setCap( genParticles_,     "genParticle",     caps, 9999 );
+  setCap( genjets_,          "genjet",          caps, 999 );
 }
 
 
@@ -78,215 +96,215 @@ tree_->Branch("event_met_phi",&Met_Phi,  "event_met_phi/F");
 
   // ----------------------- Declare branches -----------------------
   ///////////////////////////////////////////////
-  SetBranch( &l1size,           "muon_size" );
-  SetBranch( l1px,             "muon_px[muon_size]" );
-  SetBranch( l1py,             "muon_py[muon_size]" );
-  SetBranch( l1pz,             "muon_pz[muon_size]" );
-  SetBranch( l1E,              "muon_e[muon_size]" );
-  SetBranch( l1Pt,             "muon_pt[muon_size]" );
-  SetBranch( l1Eta,            "muon_eta[muon_size]" ); 
-  SetBranch( l1Phi,            "muon_phi[muon_size]" );
-  SetBranch( l1Charge,         "muon_charge[muon_size]" );
-  SetBranch( l1Vx,             "muon_vx[muon_size]" );
-  SetBranch( l1Vy,             "muon_vy[muon_size]" );
-  SetBranch( l1Vz,             "muon_vz[muon_size]" );
-  SetBranch( l1Y,              "muon_y[muon_size]" );
-  SetBranch( l1trackiso,              "muon_trackiso[muon_size]" );
-  SetBranch( l1ecaliso,              "muon_ecaliso[muon_size]" );
-  SetBranch( l1hcaliso,              "muon_hcaliso[muon_size]" );
-  SetBranch( l1Type,              "muon_Type[muon_size]" );
-  SetBranch( l1_numberOfChambers,              "muon_numberOfChambers[muon_size]" );
-  SetBranch( l1_numberOfMatches,              "muon_numberOfMatches[muon_size]" );
-  SetBranch( l1pfiso_sumChargedHadronPt,              "muon_pfiso_sumChargedHadronPt[muon_size]" );
-  SetBranch( l1pfiso_sumChargedParticlePt,              "muon_pfiso_sumChargedParticlePt[muon_size]" );
-  SetBranch( l1pfiso_sumNeutralHadronEt,              "muon_pfiso_sumNeutralHadronEt[muon_size]" );
-  SetBranch( l1pfiso_sumPhotonEt,              "muon_pfiso_sumPhotonEt[muon_size]" );
-  SetBranch( l1pfiso_sumPUPt,              "muon_pfiso_sumPUPt[muon_size]" );
-  SetBranch( l1_d0bsp,              "muon_d0bsp[muon_size]" );
-  SetBranch( l1_dz000,              "muon_dz000[muon_size]" );
-  SetBranch( l1_IP3D,              "muon_IP3D[muon_size]" );
-  SetBranch( l1_dzPV,              "muon_dzPV[muon_size]" );
-  SetBranch( l1_globalChi2,          "muon_globalChi2[muon_size]");
-  SetBranch( l1_innerChi2,          "muon_innerChi2[muon_size]");
-  SetBranch( l1_nPixelHits,        "muon_nPixelHits[muon_size]");
-  SetBranch( l1_nTrackerHits,      "muon_nTrackerHits[muon_size]");
-  SetBranch( l1_isPF,        "muon_isPF[muon_size]");
-  SetBranch( l1_isGlobal,      "muon_isGlobal[muon_size]");
-  SetBranch( l1_isTracker,      "muon_isTracker[muon_size]");
-  SetBranch( l1_hasMuonSegment, "muon_hasMuonSegment[muon_size]");
+  SetBranch( muons_ );
+  SetBranch( l1px,             "muon_px[muon_size]", muons_ );
+  SetBranch( l1py,             "muon_py[muon_size]", muons_ );
+  SetBranch( l1pz,             "muon_pz[muon_size]", muons_ );
+  SetBranch( l1E,              "muon_e[muon_size]", muons_ );
+  SetBranch( l1Pt,             "muon_pt[muon_size]", muons_ );
+  SetBranch( l1Eta,            "muon_eta[muon_size]", muons_ ); 
+  SetBranch( l1Phi,            "muon_phi[muon_size]", muons_ );
+  SetBranch( l1Charge,         "muon_charge[muon_size]", muons_ );
+  SetBranch( l1Vx,             "muon_vx[muon_size]", muons_ );
+  SetBranch( l1Vy,             "muon_vy[muon_size]", muons_ );
+  SetBranch( l1Vz,             "muon_vz[muon_size]", muons_ );
+  SetBranch( l1Y,              "muon_y[muon_size]", muons_ );
+  SetBranch( l1trackiso,              "muon_trackiso[muon_size]", muons_ );
+  SetBranch( l1ecaliso,              "muon_ecaliso[muon_size]", muons_ );
+  SetBranch( l1hcaliso,              "muon_hcaliso[muon_size]", muons_ );
+  SetBranch( l1Type,              "muon_Type[muon_size]", muons_ );
+  SetBranch( l1_numberOfChambers,              "muon_numberOfChambers[muon_size]", muons_ );
+  SetBranch( l1_numberOfMatches,              "muon_numberOfMatches[muon_size]", muons_ );
+  SetBranch( l1pfiso_sumChargedHadronPt,              "muon_pfiso_sumChargedHadronPt[muon_size]", muons_ );
+  SetBranch( l1pfiso_sumChargedParticlePt,              "muon_pfiso_sumChargedParticlePt[muon_size]", muons_ );
+  SetBranch( l1pfiso_sumNeutralHadronEt,              "muon_pfiso_sumNeutralHadronEt[muon_size]", muons_ );
+  SetBranch( l1pfiso_sumPhotonEt,              "muon_pfiso_sumPhotonEt[muon_size]", muons_ );
+  SetBranch( l1pfiso_sumPUPt,              "muon_pfiso_sumPUPt[muon_size]", muons_ );
+  SetBranch( l1_d0bsp,              "muon_d0bsp[muon_size]", muons_ );
+  SetBranch( l1_dz000,              "muon_dz000[muon_size]", muons_ );
+  SetBranch( l1_IP3D,              "muon_IP3D[muon_size]", muons_ );
+  SetBranch( l1_dzPV,              "muon_dzPV[muon_size]", muons_ );
+  SetBranch( l1_globalChi2,          "muon_globalChi2[muon_size]", muons_ );
+  SetBranch( l1_innerChi2,          "muon_innerChi2[muon_size]", muons_ );
+  SetBranch( l1_nPixelHits,        "muon_nPixelHits[muon_size]", muons_ );
+  SetBranch( l1_nTrackerHits,      "muon_nTrackerHits[muon_size]", muons_ );
+  SetBranch( l1_isPF,        "muon_isPF[muon_size]", muons_ );
+  SetBranch( l1_isGlobal,      "muon_isGlobal[muon_size]", muons_ );
+  SetBranch( l1_isTracker,      "muon_isTracker[muon_size]", muons_ );
+  SetBranch( l1_hasMuonSegment, "muon_hasMuonSegment[muon_size]", muons_ );
 
   ////////////////////////////////////////////////////////
-  SetBranch( &l2size,           "electron_size" );
-  SetBranch( l2px,             "electron_px[electron_size]" );
-  SetBranch( l2py,             "electron_py[electron_size]" );
-  SetBranch( l2pz,             "electron_pz[electron_size]" );
-  SetBranch( l2E,              "electron_e[electron_size]" );
-  SetBranch( l2Pt,             "electron_pt[electron_size]" );
-  SetBranch( l2Eta,            "electron_eta[electron_size]" ); 
-  SetBranch( l2Phi,            "electron_phi[electron_size]" );
-  SetBranch( l2Charge,         "electron_charge[electron_size]" );
-  SetBranch( l2Vx,             "electron_vx[electron_size]" );
-  SetBranch( l2Vy,             "electron_vy[electron_size]" );
-  SetBranch( l2Vz,             "electron_vz[electron_size]" );
-  SetBranch( l2Y,              "electron_y[electron_size]" );
-  SetBranch( l2trackiso,              "electron_trackiso[electron_size]" );
-  SetBranch( l2ecaliso,              "electron_ecaliso[electron_size]" );
-  SetBranch( l2hcaliso,              "electron_hcaliso[electron_size]" );
-  SetBranch( l2_classification,              "electron_classification[electron_size]" );
-  SetBranch( l2_HoverE,              "electron_HoverE[electron_size]" );
-  SetBranch( l2_EoverP,              "electron_EoverP[electron_size]" );
-  SetBranch( l2_DeltaEta,              "electron_DeltaEta[electron_size]" );
-  SetBranch( l2_DeltaPhi,              "electron_DeltaPhi[electron_size]" );
-  SetBranch( l2_numberOfBrems,              "electron_numberOfBrems[electron_size]" );
-  SetBranch( l2_BremFraction,              "electron_BremFraction[electron_size]" );
-  SetBranch( l2_SigmaIetaIeta,              "electron_SigmaIetaIeta[electron_size]" );
-  SetBranch( l2_missingHits,              "electron_missingHits[electron_size]" );
-  SetBranch( l2_dist,              "electron_convDist[electron_size]" );
-  SetBranch( l2_dcot,              "electron_convDcot[electron_size]" );
-  SetBranch( l2_convradius,              "electron_convRadius[electron_size]" );
-  SetBranch( l2pfiso_chargedHadronIso,              "electron_pfiso_chargedHadron[electron_size]" );
-  SetBranch( l2pfiso_photonIso,              "electron_pfiso_photon[electron_size]" );
-  SetBranch( l2pfiso_neutralHadronIso,              "electron_pfiso_neutralHadron[electron_size]" );
-  SetBranch( l2pfiso_EffAreaPU,              "electron_pfiso_EffAreaPU[electron_size]" );
-  SetBranch( l2pfiso_pfIsoEA,              "electron_pfiso_pfIsoEA[electron_size]" );
-  SetBranch( l2_d0bsp,              "electron_d0bsp[electron_size]" );
-  SetBranch( l2_dz000,              "electron_dz000[electron_size]" );
-  SetBranch( l2_IP3D,              "electron_IP3D[electron_size]" );
-  SetBranch( l2_dzPV,              "electron_dzPV[electron_size]" );
+  SetBranch( electrons_ );
+  SetBranch( l2px,             "electron_px[electron_size]", electrons_ );
+  SetBranch( l2py,             "electron_py[electron_size]", electrons_ );
+  SetBranch( l2pz,             "electron_pz[electron_size]", electrons_ );
+  SetBranch( l2E,              "electron_e[electron_size]", electrons_ );
+  SetBranch( l2Pt,             "electron_pt[electron_size]", electrons_ );
+  SetBranch( l2Eta,            "electron_eta[electron_size]", electrons_ ); 
+  SetBranch( l2Phi,            "electron_phi[electron_size]", electrons_ );
+  SetBranch( l2Charge,         "electron_charge[electron_size]", electrons_ );
+  SetBranch( l2Vx,             "electron_vx[electron_size]", electrons_ );
+  SetBranch( l2Vy,             "electron_vy[electron_size]", electrons_ );
+  SetBranch( l2Vz,             "electron_vz[electron_size]", electrons_ );
+  SetBranch( l2Y,              "electron_y[electron_size]", electrons_ );
+  SetBranch( l2trackiso,              "electron_trackiso[electron_size]", electrons_ );
+  SetBranch( l2ecaliso,              "electron_ecaliso[electron_size]", electrons_ );
+  SetBranch( l2hcaliso,              "electron_hcaliso[electron_size]", electrons_ );
+  SetBranch( l2_classification,              "electron_classification[electron_size]", electrons_ );
+  SetBranch( l2_HoverE,              "electron_HoverE[electron_size]", electrons_ );
+  SetBranch( l2_EoverP,              "electron_EoverP[electron_size]", electrons_ );
+  SetBranch( l2_DeltaEta,              "electron_DeltaEta[electron_size]", electrons_ );
+  SetBranch( l2_DeltaPhi,              "electron_DeltaPhi[electron_size]", electrons_ );
+  SetBranch( l2_numberOfBrems,              "electron_numberOfBrems[electron_size]", electrons_ );
+  SetBranch( l2_BremFraction,              "electron_BremFraction[electron_size]", electrons_ );
+  SetBranch( l2_SigmaIetaIeta,              "electron_SigmaIetaIeta[electron_size]", electrons_ );
+  SetBranch( l2_missingHits,              "electron_missingHits[electron_size]", electrons_ );
+  SetBranch( l2_dist,              "electron_convDist[electron_size]", electrons_ );
+  SetBranch( l2_dcot,              "electron_convDcot[electron_size]", electrons_ );
+  SetBranch( l2_convradius,              "electron_convRadius[electron_size]", electrons_ );
+  SetBranch( l2pfiso_chargedHadronIso,              "electron_pfiso_chargedHadron[electron_size]", electrons_ );
+  SetBranch( l2pfiso_photonIso,              "electron_pfiso_photon[electron_size]", electrons_ );
+  SetBranch( l2pfiso_neutralHadronIso,              "electron_pfiso_neutralHadron[electron_size]", electrons_ );
+  SetBranch( l2pfiso_EffAreaPU,              "electron_pfiso_EffAreaPU[electron_size]", electrons_ );
+  SetBranch( l2pfiso_pfIsoEA,              "electron_pfiso_pfIsoEA[electron_size]", electrons_ );
+  SetBranch( l2_d0bsp,              "electron_d0bsp[electron_size]", electrons_ );
+  SetBranch( l2_dz000,              "electron_dz000[electron_size]", electrons_ );
+  SetBranch( l2_IP3D,              "electron_IP3D[electron_size]", electrons_ );
+  SetBranch( l2_dzPV,              "electron_dzPV[electron_size]", electrons_ );
 
   ////////////////////////////////////////////////////////
-  SetBranch( &jet_size,          "jet_size" );
-  SetBranch( jet_px,             "jet_px[jet_size]" );
-  SetBranch( jet_py,             "jet_py[jet_size]" );
-  SetBranch( jet_pz,             "jet_pz[jet_size]" );
-  SetBranch( jet_E,              "jet_E[jet_size]" );
-  SetBranch( jet_Pt,             "jet_pt[jet_size]" );
-  SetBranch( jet_Eta,            "jet_eta[jet_size]" ); 
-  SetBranch( jet_Phi,            "jet_phi[jet_size]" );
-  SetBranch( jet_Y,              "jet_y[jet_size]" );
-  SetBranch( jet_area,           "jet_area[jet_size]" );
-  SetBranch( jet_bDiscriminatorSSVHE,           "jet_bDiscriminatorSSVHE[jet_size]" );
-  SetBranch( jet_bDiscriminatorTCHE,           "jet_bDiscriminatorTCHE[jet_size]" );
-  SetBranch( jet_bDiscriminatorCSV,           "jet_bDiscriminatorCSV[jet_size]" );
-  SetBranch( jet_bDiscriminatorJP,           "jet_bDiscriminatorJP[jet_size]" );
-  SetBranch( jet_bDiscriminatorSSVHP,           "jet_bDiscriminatorSSVHP[jet_size]" );
-  SetBranch( jet_bDiscriminatorTCHP,           "jet_bDiscriminatorTCHP[jet_size]" );
+  SetBranch( jets_ );
+  SetBranch( jet_px,             "jet_px[jet_size]", jets_ );
+  SetBranch( jet_py,             "jet_py[jet_size]", jets_ );
+  SetBranch( jet_pz,             "jet_pz[jet_size]", jets_ );
+  SetBranch( jet_E,              "jet_E[jet_size]", jets_ );
+  SetBranch( jet_Pt,             "jet_pt[jet_size]", jets_ );
+  SetBranch( jet_Eta,            "jet_eta[jet_size]", jets_ ); 
+  SetBranch( jet_Phi,            "jet_phi[jet_size]", jets_ );
+  SetBranch( jet_Y,              "jet_y[jet_size]", jets_ );
+  SetBranch( jet_area,           "jet_area[jet_size]", jets_ );
+  SetBranch( jet_bDiscriminatorSSVHE,           "jet_bDiscriminatorSSVHE[jet_size]", jets_ );
+  SetBranch( jet_bDiscriminatorTCHE,           "jet_bDiscriminatorTCHE[jet_size]", jets_ );
+  SetBranch( jet_bDiscriminatorCSV,           "jet_bDiscriminatorCSV[jet_size]", jets_ );
+  SetBranch( jet_bDiscriminatorJP,           "jet_bDiscriminatorJP[jet_size]", jets_ );
+  SetBranch( jet_bDiscriminatorSSVHP,           "jet_bDiscriminatorSSVHP[jet_size]", jets_ );
+  SetBranch( jet_bDiscriminatorTCHP,           "jet_bDiscriminatorTCHP[jet_size]", jets_ );
 
   ////////////////////////////////////////////////////////
-  SetBranch( &photon_size,          "photon_size" );
-  SetBranch( photon_px, "photon_px[photon_size]");
-  SetBranch( photon_py, "photon_py[photon_size]");
-  SetBranch( photon_pz, "photon_pz[photon_size]");
-  SetBranch( photon_E, "photon_E[photon_size]");
-  SetBranch( photon_pt, "photon_pt[photon_size]");
-  SetBranch( photon_eta, "photon_eta[photon_size]");
-  SetBranch( photon_phi, "photon_phi[photon_size]");
-  SetBranch( photon_vx, "photon_vx[photon_size]");
-  SetBranch( photon_vy, "photon_vy[photon_size]");
-  SetBranch( photon_vz, "photon_vz[photon_size]");
-//   SetBranch( photon_pfiso_charged, "photon_pfiso_charged[photon_size]");
-//   SetBranch( photon_pfiso_photon, "photon_pfiso_photon[photon_size]");
-//   SetBranch( photon_pfiso_neutral, "photon_pfiso_neutral[photon_size]");
-  SetBranch( photon_trackiso, "photon_trackiso[photon_size]");
-  SetBranch( photon_ecaliso, "photon_ecaliso[photon_size]");
-  SetBranch( photon_hcaliso, "photon_hcaliso[photon_size]");
-  SetBranch( photon_HoverE, "photon_HoverE[photon_size]");
-  SetBranch( photon_SigmaIetaIeta, "photon_SigmaIetaIeta[photon_size]");
-  SetBranch( photon_hasPixelSeed, "photon_hasPixelSeed[photon_size]");
-  SetBranch( photon_passElecVeto, "photon_passElecVeto[photon_size]");
+  SetBranch( photons_ );
+  SetBranch( photon_px, "photon_px[photon_size]", photons_ );
+  SetBranch( photon_py, "photon_py[photon_size]", photons_ );
+  SetBranch( photon_pz, "photon_pz[photon_size]", photons_ );
+  SetBranch( photon_E, "photon_E[photon_size]", photons_ );
+  SetBranch( photon_pt, "photon_pt[photon_size]", photons_ );
+  SetBranch( photon_eta, "photon_eta[photon_size]", photons_ );
+  SetBranch( photon_phi, "photon_phi[photon_size]", photons_ );
+  SetBranch( photon_vx, "photon_vx[photon_size]", photons_ );
+  SetBranch( photon_vy, "photon_vy[photon_size]", photons_ );
+  SetBranch( photon_vz, "photon_vz[photon_size]", photons_ );
+//   SetBranch( photon_pfiso_charged, "photon_pfiso_charged[photon_size]", photons_ );
+//   SetBranch( photon_pfiso_photon, "photon_pfiso_photon[photon_size]", photons_ );
+//   SetBranch( photon_pfiso_neutral, "photon_pfiso_neutral[photon_size]", photons_ );
+  SetBranch( photon_trackiso, "photon_trackiso[photon_size]", photons_ );
+  SetBranch( photon_ecaliso, "photon_ecaliso[photon_size]", photons_ );
+  SetBranch( photon_hcaliso, "photon_hcaliso[photon_size]", photons_ );
+  SetBranch( photon_HoverE, "photon_HoverE[photon_size]", photons_ );
+  SetBranch( photon_SigmaIetaIeta, "photon_SigmaIetaIeta[photon_size]", photons_ );
+  SetBranch( photon_hasPixelSeed, "photon_hasPixelSeed[photon_size]", photons_ );
+  SetBranch( photon_passElecVeto, "photon_passElecVeto[photon_size]", photons_ );
 
   ////////////////////////////////////////////////////////  
-  SetBranch( &track_size,            "track_size" );
-  SetBranch( track_px,               "track_px[track_size]" );
-  SetBranch( track_py,               "track_py[track_size]" );
-  SetBranch( track_pz,               "track_pz[track_size]" );
-  SetBranch( track_Vx,               "track_Vx[track_size]" );
-  SetBranch( track_Vy,               "track_Vy[track_size]" );
-  SetBranch( track_Vz,               "track_Vz[track_size]" );
-  SetBranch( track_Pt,               "track_Pt[track_size]" );
-  SetBranch( track_Eta,              "track_Eta[track_size]" );
-  SetBranch( track_Phi,              "track_Phi[track_size]" );
+  SetBranch( tracks_ );
+  SetBranch( track_px,               "track_px[track_size]", tracks_ );
+  SetBranch( track_py,               "track_py[track_size]", tracks_ );
+  SetBranch( track_pz,               "track_pz[track_size]", tracks_ );
+  SetBranch( track_Vx,               "track_Vx[track_size]", tracks_ );
+  SetBranch( track_Vy,               "track_Vy[track_size]", tracks_ );
+  SetBranch( track_Vz,               "track_Vz[track_size]", tracks_ );
+  SetBranch( track_Pt,               "track_Pt[track_size]", tracks_ );
+  SetBranch( track_Eta,              "track_Eta[track_size]", tracks_ );
+  SetBranch( track_Phi,              "track_Phi[track_size]", tracks_ );
   
   ////////////////////////////////////////////////////////
-  SetBranch( &gsftrack_size,            "gsftrack_size" );
-  SetBranch( gsftrack_px,               "gsftrack_px[gsftrack_size]" );
-  SetBranch( gsftrack_py,               "gsftrack_py[gsftrack_size]" );
-  SetBranch( gsftrack_pz,               "gsftrack_pz[gsftrack_size]" );
-  SetBranch( gsftrack_Vx,               "gsftrack_Vx[gsftrack_size]" );
-  SetBranch( gsftrack_Vy,               "gsftrack_Vy[gsftrack_size]" );
-  SetBranch( gsftrack_Vz,               "gsftrack_Vz[gsftrack_size]" );
-  SetBranch( gsftrack_Pt,               "gsftrack_Pt[gsftrack_size]" );
-  SetBranch( gsftrack_Eta,              "gsftrack_Eta[gsftrack_size]" );
-  SetBranch( gsftrack_Phi,              "gsftrack_Phi[gsftrack_size]" );
+  SetBranch( gsftracks_ );
+  SetBranch( gsftrack_px,               "gsftrack_px[gsftrack_size]", gsftracks_ );
+  SetBranch( gsftrack_py,               "gsftrack_py[gsftrack_size]", gsftracks_ );
+  SetBranch( gsftrack_pz,               "gsftrack_pz[gsftrack_size]", gsftracks_ );
+  SetBranch( gsftrack_Vx,               "gsftrack_Vx[gsftrack_size]", gsftracks_ );
+  SetBranch( gsftrack_Vy,               "gsftrack_Vy[gsftrack_size]", gsftracks_ );
+  SetBranch( gsftrack_Vz,               "gsftrack_Vz[gsftrack_size]", gsftracks_ );
+  SetBranch( gsftrack_Pt,               "gsftrack_Pt[gsftrack_size]", gsftracks_ );
+  SetBranch( gsftrack_Eta,              "gsftrack_Eta[gsftrack_size]", gsftracks_ );
+  SetBranch( gsftrack_Phi,              "gsftrack_Phi[gsftrack_size]", gsftracks_ );
 
   ////////////////////////////////////////////////////////  
-  SetBranch( &superCluster_size,              "superCluster_size"  );
-  SetBranch( superCluster_E    ,              "superCluster_E[superCluster_size]"     );
-  SetBranch( superCluster_rawE ,              "superCluster_rawE[superCluster_size]"  );
-  SetBranch( superCluster_x    ,              "superCluster_x[superCluster_size]"     );
-  SetBranch( superCluster_y    ,              "superCluster_y[superCluster_size]"     );
-  SetBranch( superCluster_z    ,              "superCluster_z[superCluster_size]"     );
-  SetBranch( superCluster_Eta  ,              "superCluster_Eta[superCluster_size]"   );
-  SetBranch( superCluster_Phi  ,              "superCluster_Phi[superCluster_size]"   );
-  SetBranch( superCluster_nHits,              "superCluster_nHits[superCluster_size]" );
+  SetBranch( superClusters_ );
+  SetBranch( superCluster_E    ,              "superCluster_E[superCluster_size]", superClusters_ );
+  SetBranch( superCluster_rawE ,              "superCluster_rawE[superCluster_size]", superClusters_ );
+  SetBranch( superCluster_x    ,              "superCluster_x[superCluster_size]", superClusters_ );
+  SetBranch( superCluster_y    ,              "superCluster_y[superCluster_size]", superClusters_ );
+  SetBranch( superCluster_z    ,              "superCluster_z[superCluster_size]", superClusters_ );
+  SetBranch( superCluster_Eta  ,              "superCluster_Eta[superCluster_size]", superClusters_ );
+  SetBranch( superCluster_Phi  ,              "superCluster_Phi[superCluster_size]", superClusters_ );
+  SetBranch( superCluster_nHits,              "superCluster_nHits[superCluster_size]", superClusters_ );
 
   ////////////////////////////////////////////////////////  
-  SetBranch( &superCluster5x5_size,              "superCluster5x5_size"  );
-  SetBranch( superCluster5x5_E    ,              "superCluster5x5_E[superCluster5x5_size]"     );
-  SetBranch( superCluster5x5_rawE ,              "superCluster5x5_rawE[superCluster5x5_size]"  );
-  SetBranch( superCluster5x5_x    ,              "superCluster5x5_x[superCluster5x5_size]"     );
-  SetBranch( superCluster5x5_y    ,              "superCluster5x5_y[superCluster5x5_size]"     );
-  SetBranch( superCluster5x5_z    ,              "superCluster5x5_z[superCluster5x5_size]"     );
-  SetBranch( superCluster5x5_Eta  ,              "superCluster5x5_Eta[superCluster5x5_size]"   );
-  SetBranch( superCluster5x5_Phi  ,              "superCluster5x5_Phi[superCluster5x5_size]"   );
-  SetBranch( superCluster5x5_nHits,              "superCluster5x5_nHits[superCluster5x5_size]" );
+  SetBranch( superClusters5x5_ );
+  SetBranch( superCluster5x5_E    ,              "superCluster5x5_E[superCluster5x5_size]", superClusters5x5_ );
+  SetBranch( superCluster5x5_rawE ,              "superCluster5x5_rawE[superCluster5x5_size]", superClusters5x5_ );
+  SetBranch( superCluster5x5_x    ,              "superCluster5x5_x[superCluster5x5_size]", superClusters5x5_ );
+  SetBranch( superCluster5x5_y    ,              "superCluster5x5_y[superCluster5x5_size]", superClusters5x5_ );
+  SetBranch( superCluster5x5_z    ,              "superCluster5x5_z[superCluster5x5_size]", superClusters5x5_ );
+  SetBranch( superCluster5x5_Eta  ,              "superCluster5x5_Eta[superCluster5x5_size]", superClusters5x5_ );
+  SetBranch( superCluster5x5_Phi  ,              "superCluster5x5_Phi[superCluster5x5_size]", superClusters5x5_ );
+  SetBranch( superCluster5x5_nHits,              "superCluster5x5_nHits[superCluster5x5_size]", superClusters5x5_ );
 
   ////////////////////////////////////////////////////////  
-  SetBranch( &caloTower_size     ,               "caloTower_size"                 );
-  SetBranch( caloTower_hadE      ,               "caloTower_hadE[caloTower_size]" );
-  SetBranch( caloTower_emE       ,               "caloTower_emE[caloTower_size]"  );
-  SetBranch( caloTower_hadEt     ,               "caloTower_hadEt[caloTower_size]");
-  SetBranch( caloTower_emEt      ,               "caloTower_emEt[caloTower_size]" );
-  SetBranch( caloTower_Eta       ,               "caloTower_Eta[caloTower_size]"  );
-  SetBranch( caloTower_Phi       ,               "caloTower_Phi[caloTower_size]"  );
+  SetBranch( caloTowers_ );
+  SetBranch( caloTower_hadE      ,               "caloTower_hadE[caloTower_size]", caloTowers_ );
+  SetBranch( caloTower_emE       ,               "caloTower_emE[caloTower_size]", caloTowers_ );
+  SetBranch( caloTower_hadEt     ,               "caloTower_hadEt[caloTower_size]", caloTowers_ );
+  SetBranch( caloTower_emEt      ,               "caloTower_emEt[caloTower_size]", caloTowers_ );
+  SetBranch( caloTower_Eta       ,               "caloTower_Eta[caloTower_size]", caloTowers_ );
+  SetBranch( caloTower_Phi       ,               "caloTower_Phi[caloTower_size]", caloTowers_ );
 
   ////////////////////////////////////////////////////////  
-  SetBranch( &tau_size,            "tau_size" );
-  SetBranch( tau_px,               "tau_px[tau_size]" );
-  SetBranch( tau_py,               "tau_py[tau_size]" );
-  SetBranch( tau_pz,               "tau_pz[tau_size]" );
-  SetBranch( tau_Pt,               "tau_Pt[tau_size]" );
-  SetBranch( tau_Eta,              "tau_Eta[tau_size]" );
-  SetBranch( tau_Phi,              "tau_Phi[tau_size]" );
+  SetBranch( taus_ );
+  SetBranch( tau_px,               "tau_px[tau_size]", taus_ );
+  SetBranch( tau_py,               "tau_py[tau_size]", taus_ );
+  SetBranch( tau_pz,               "tau_pz[tau_size]", taus_ );
+  SetBranch( tau_Pt,               "tau_Pt[tau_size]", taus_ );
+  SetBranch( tau_Eta,              "tau_Eta[tau_size]", taus_ );
+  SetBranch( tau_Phi,              "tau_Phi[tau_size]", taus_ );
 
   ///////////////////////////////////////////////
-  SetBranch( &genPart_size,          "genParticle_size" );
-  SetBranch( genPart_px,             "genParticle_px[genParticle_size]" );
-  SetBranch( genPart_py,             "genParticle_py[genParticle_size]" );
-  SetBranch( genPart_pz,             "genParticle_pz[genParticle_size]" );
-  SetBranch( genPart_E,              "genParticle_e[genParticle_size]" );
-  SetBranch( genPart_Pt,             "genParticle_pt[genParticle_size]" );
-  SetBranch( genPart_Eta,            "genParticle_eta[genParticle_size]" ); 
-  SetBranch( genPart_Phi,            "genParticle_phi[genParticle_size]" );
-  SetBranch( genPart_Charge,         "genParticle_charge[genParticle_size]" );
-  SetBranch( genPart_Vx,             "genParticle_vx[genParticle_size]" );
-  SetBranch( genPart_Vy,             "genParticle_vy[genParticle_size]" );
-  SetBranch( genPart_Vz,             "genParticle_vz[genParticle_size]" );
-  SetBranch( genPart_Y,              "genParticle_y[genParticle_size]" );
-  SetBranch( genPart_Status,         "genPart_Status[genParticle_size]" );
-  SetBranch( genPart_pdgId,          "genPart_pdgId[genParticle_size]" );
+  SetBranch( genParticles_ );
+  SetBranch( genPart_px,             "genParticle_px[genParticle_size]", genParticles_ );
+  SetBranch( genPart_py,             "genParticle_py[genParticle_size]", genParticles_ );
+  SetBranch( genPart_pz,             "genParticle_pz[genParticle_size]", genParticles_ );
+  SetBranch( genPart_E,              "genParticle_e[genParticle_size]", genParticles_ );
+  SetBranch( genPart_Pt,             "genParticle_pt[genParticle_size]", genParticles_ );
+  SetBranch( genPart_Eta,            "genParticle_eta[genParticle_size]", genParticles_ ); 
+  SetBranch( genPart_Phi,            "genParticle_phi[genParticle_size]", genParticles_ );
+  SetBranch( genPart_Charge,         "genParticle_charge[genParticle_size]", genParticles_ );
+  SetBranch( genPart_Vx,             "genParticle_vx[genParticle_size]", genParticles_ );
+  SetBranch( genPart_Vy,             "genParticle_vy[genParticle_size]", genParticles_ );
+  SetBranch( genPart_Vz,             "genParticle_vz[genParticle_size]", genParticles_ );
+  SetBranch( genPart_Y,              "genParticle_y[genParticle_size]", genParticles_ );
+  SetBranch( genPart_Status,         "genPart_Status[genParticle_size]", genParticles_ );
+  SetBranch( genPart_pdgId,          "genPart_pdgId[genParticle_size]", genParticles_ );
 
   ////////////////////////////////////////////////////////
-  SetBranch( &genjet_size,          "genjet_size" );
-  SetBranch( genjet_px,             "genjet_px[genjet_size]" );
-  SetBranch( genjet_py,             "genjet_py[genjet_size]" );
-  SetBranch( genjet_pz,             "genjet_pz[genjet_size]" );
-  SetBranch( genjet_E,              "genjet_E[genjet_size]" );
-  SetBranch( genjet_Pt,             "genjet_pt[genjet_size]" );
-  SetBranch( genjet_Eta,            "genjet_eta[genjet_size]" ); 
-  SetBranch( genjet_Phi,            "genjet_phi[genjet_size]" );
-  SetBranch( genjet_Y,              "genjet_y[genjet_size]" );
-  SetBranch( genjet_area,           "genjet_area[genjet_size]" );
+  SetBranch( genjets_ );
+  SetBranch( genjet_px,             "genjet_px[genjet_size]", genjets_ );
+  SetBranch( genjet_py,             "genjet_py[genjet_size]", genjets_ );
+  SetBranch( genjet_pz,             "genjet_pz[genjet_size]", genjets_ );
+  SetBranch( genjet_E,              "genjet_E[genjet_size]", genjets_ );
+  SetBranch( genjet_Pt,             "genjet_pt[genjet_size]", genjets_ );
+  SetBranch( genjet_Eta,            "genjet_eta[genjet_size]", genjets_ ); 
+  SetBranch( genjet_Phi,            "genjet_phi[genjet_size]", genjets_ );
+  SetBranch( genjet_Y,              "genjet_y[genjet_size]", genjets_ );
+  SetBranch( genjet_area,           "genjet_area[genjet_size]", genjets_ );
 
 }
 /////////////////////////////////////////////////////////////////////////
@@ -299,19 +317,20 @@ tree_->Branch("event_met_phi",&Met_Phi,  "event_met_phi/F");
 
 void ewk::SnowmassTreeProducer::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
 {
-  // first initialize to the default values
-  genPart_size       = 0;
-  l1size             = 0; 
-  l2size             = 0;
-  jet_size           = 0;
-  photon_size        = 0;
-  genjet_size        = 0;
-  track_size         = 0;
-  gsftrack_size      = 0;
-  superCluster_size  = 0;
-  superCluster5x5_size = 0;
-  caloTower_size     = 0;
-  tau_size         = 0;
+  // first initialize to the default values: only the entry counters
+  // are reset, the per-entry defaults are written as each entry is added
+  muons_.clear();
+  electrons_.clear();
+  jets_.clear();
+  photons_.clear();
+  genParticles_.clear();
+  genjets_.clear();
+  tracks_.clear();
+  gsftracks_.clear();
+  superClusters_.clear();
+  superClusters5x5_.clear();
+  caloTowers_.clear();
+  taus_.clear();
 
   Met_px              = -99999.;
   Met_py              = -99999.;
@@ -319,196 +338,6 @@ void ewk::SnowmassTreeProducer::analyze(const edm::Event& iEvent, const edm::Eve
   Met_Phi             = -99999.;
   Met_SumET           = -99999.;
 
-  for ( int i =0; i<999; i++){
-
-    l1Charge[i]           = -99999;
-    l1px[i]               = -99999.;
-    l1py[i]               = -99999.;
-    l1pz[i]               = -99999.;
-    l1E[i]                = -99999.;
-    l1Pt[i]               = -99999.;
-    l1Eta[i]              = -99999.;
-    l1Phi[i]              = -99999.;
-    l1Vx[i]               = -99999.;
-    l1Vy[i]               = -99999.;
-    l1Vz[i]               = -99999.;
-    l1Y[i]                = -99999.;
-    l1trackiso[i]= -99999.;
-    l1ecaliso[i]= -99999.;
-    l1hcaliso[i]= -99999.;
-    l1Type[i]= -99999;
-    l1_numberOfChambers[i]= -99999.;      
-    l1_numberOfMatches[i]= -99999.;
-    l1pfiso_sumChargedHadronPt[i]= -99999.;
-    l1pfiso_sumChargedParticlePt[i]= -99999.;
-    l1pfiso_sumNeutralHadronEt[i]= -99999.;
-    l1pfiso_sumPhotonEt[i]= -99999.;
-    l1pfiso_sumPUPt[i]= -99999.;
-    l1_d0bsp[i]= -99999.;
-    l1_dz000[i]= -99999.;
-    l1_IP3D[i]= -99999.;
-    l1_dzPV[i]= -99999.;
-    l1_globalChi2[i]=-99999.;
-    l1_innerChi2[i]=-99999.;
-    l1_nPixelHits[i]=-99999.;
-    l1_nTrackerHits[i]=-99999.;
-    l1_isPF[i]=-99999;
-    l1_isGlobal[i]=-99999;
-    l1_isTracker[i]=-99999;
-    l1_hasMuonSegment[i]=-99999;
-
-    l2Charge[i]           = -99999;  
-    l2px[i]               = -99999.;
-    l2py[i]               = -99999.;
-    l2pz[i]               = -99999.;
-    l2E[i]                = -99999.;
-    l2Pt[i]               = -99999.;
-    l2Eta[i]              = -99999.;
-    l2Phi[i]              = -99999.;
-    l2Vx[i]               = -99999.;
-    l2Vy[i]               = -99999.;
-    l2Vz[i]               = -99999.;
-    l2Y[i]                = -99999.;
-    l2trackiso[i]       = -99999.;
-    l2ecaliso[i]        = -99999.;
-    l2hcaliso[i]        = -99999.;
-    l2_classification[i]  = -99999;
-    l2_HoverE[i] = -99999.; 
-    l2_EoverP[i]       = -99999.;
-    l2_DeltaEta[i]     = -99999.;
-    l2_DeltaPhi[i]     = -99999.;
-    l2_numberOfBrems[i]  = -99999;      
-    l2_BremFraction[i]   = -99999.;
-    l2_SigmaIetaIeta[i] = -99999.;
-    l2_missingHits[i]   = -99999;
-    l2_dist[i]          = -99999.;
-    l2_dcot[i]          = -99999.;
-    l2_convradius[i]    = -99999.;
-    l2pfiso_chargedHadronIso[i]   = -99999.;
-    l2pfiso_photonIso[i] = -99999.;
-    l2pfiso_neutralHadronIso[i]   = -99999.;
-    l2pfiso_EffAreaPU[i] = -99999.;
-    l2pfiso_pfIsoEA[i] = -99999.;
-    l2_d0bsp[i] = -99999.;
-    l2_dz000[i] = -99999.;
-    l2_IP3D[i] = -99999.;
-    l2_dzPV[i] = -99999.;
-
-
-    jet_px[i]             = -99999.;
-    jet_py[i]             = -99999.;
-    jet_pz[i]             = -99999.;
-    jet_E[i]              = -99999.;
-    jet_Pt[i]             = -99999.;
-    jet_Eta[i]            = -99999.;
-    jet_Phi[i]            = -99999.;
-    jet_Y[i]              = -99999.;
-    jet_area[i]           = -99999.;
-    jet_bDiscriminatorSSVHE[i] = -99999.;
-    jet_bDiscriminatorTCHE[i]  = -99999.;
-    jet_bDiscriminatorCSV[i]   = -99999.;
-    jet_bDiscriminatorJP[i]    = -99999.;
-    jet_bDiscriminatorSSVHP[i] = -99999.;
-    jet_bDiscriminatorTCHP[i]  = -99999.;
-    
-    photon_px[i]  = -99999.;
-    photon_py[i]  = -99999.;
-    photon_pz[i]  = -99999.;
-    photon_E[i]  = -99999.;
-    photon_pt[i]  = -99999.;
-    photon_eta[i]  = -99999.;
-    photon_phi[i]  = -99999.;
-    photon_vx[i]  = -99999.;
-    photon_vy[i]  = -99999.;
-    photon_vz[i]  = -99999.;
-    photon_pfiso_charged[i]  = -99999.;
-    photon_pfiso_photon[i]  = -99999.;
-    photon_pfiso_neutral[i]  = -99999.;
-    photon_trackiso[i]  = -99999.;
-    photon_ecaliso[i]  = -99999.;
-    photon_hcaliso[i]  = -99999.;
-    photon_HoverE[i]  = -99999.;
-    photon_SigmaIetaIeta[i]  = -99999.;
-    photon_hasPixelSeed[i]  = 0;
-    photon_passElecVeto[i]  = 0;
-
-    track_px[i]                 = -99999.;
-    track_py[i]                 = -99999.;
-    track_pz[i]                 = -99999.;
-    track_Vx[i]                 = -99999.;
-    track_Vy[i]                 = -99999.;
-    track_Vz[i]                 = -99999.;
-    track_Pt[i]                 = -99999.;
-    track_Eta[i]                = -99999.;
-    track_Phi[i]                = -99999.;
-
-    gsftrack_px[i]                 = -99999.;
-    gsftrack_py[i]                 = -99999.;
-    gsftrack_pz[i]                 = -99999.;
-    gsftrack_Vx[i]                 = -99999.;
-    gsftrack_Vy[i]                 = -99999.;
-    gsftrack_Vz[i]                 = -99999.;
-    gsftrack_Pt[i]                 = -99999.;
-    gsftrack_Eta[i]                = -99999.;
-    gsftrack_Phi[i]                = -99999.;
-
-    superCluster_E[i]      = -99999.;
-    superCluster_rawE[i]   = -99999.;
-    superCluster_x[i]      = -99999.;
-    superCluster_y[i]      = -99999.;
-    superCluster_z[i]      = -99999.;
-    superCluster_Eta[i]    = -99999.;
-    superCluster_Phi[i]    = -99999.;
-    superCluster_nHits[i]  = -99999.;
-
-    superCluster5x5_E[i]      = -99999.;
-    superCluster5x5_rawE[i]   = -99999.;
-    superCluster5x5_x[i]      = -99999.;
-    superCluster5x5_y[i]      = -99999.;
-    superCluster5x5_z[i]      = -99999.;
-    superCluster5x5_Eta[i]    = -99999.;
-    superCluster5x5_Phi[i]    = -99999.;
-    superCluster5x5_nHits[i]  = -99999.;
-
-    caloTower_hadE[i]      = -99999.;
-    caloTower_emE[i]       = -99999.;
-    caloTower_hadEt[i]     = -99999.;
-    caloTower_emEt[i]      = -99999.;
-    caloTower_Eta[i]       = -99999.;
-    caloTower_Phi[i]       = -99999.;
-
-    tau_px[i]                 = -99999.;
-    tau_py[i]                 = -99999.;
-    tau_pz[i]                 = -99999.;
-    tau_Pt[i]                 = -99999.;
-    tau_Eta[i]                = -99999.;
-    tau_Phi[i]                = -99999.;
-
-    genjet_px[i]             = -99999.;
-    genjet_py[i]             = -99999.;
-    genjet_pz[i]             = -99999.;
-    genjet_E[i]              = -99999.;
-    genjet_Pt[i]             = -99999.;
-    genjet_Eta[i]            = -99999.;
-    genjet_Phi[i]            = -99999.;
-    genjet_Y[i]              = -99999.;
-    genjet_area[i]           = -99999.;
-
-    genPart_Charge[i]           = -99999;
-    genPart_px[i]               = -99999.;
-    genPart_py[i]               = -99999.;
-    genPart_pz[i]               = -99999.;
-    genPart_E[i]                = -99999.;
-    genPart_Pt[i]               = -99999.;
-    genPart_Eta[i]              = -99999.;
-    genPart_Phi[i]              = -99999.;
-    genPart_Vx[i]               = -99999.;
-    genPart_Vy[i]               = -99999.;
-    genPart_Vz[i]               = -99999.;
-    genPart_Y[i]                = -99999.;  
-    genPart_Status[i]           = -99999;
-    genPart_pdgId[i]            = -99999;
-  }
   // initialization done
 
 
@@ -556,11 +385,13 @@ void ewk::SnowmassTreeProducer::analyze(const edm::Event& iEvent, const edm::Eve
   typedef edm::View<reco::Muon> MuonView;
   edm::Handle<MuonView> muons;
   iEvent.getByLabel( "selectedPatMuonsPFlow", muons);
-  l1size  = (int) (muons->size()); 
-  if( l1size > 0 ) {
-    int iMuon = 0;
+  if( muons->size() > 0 ) {
     edm::View<reco::Muon>::const_iterator muon, endpmuons = muons->end(); 
-    for (muon = muons->begin();  muon != endpmuons;  ++muon, ++iMuon) {
+    for (muon = muons->begin();  muon != endpmuons;  ++muon) {
+      const int iMuon = muons_.next();
+      if (iMuon < 0) continue;
+      l1_dzPV[iMuon]       = -99999.;
+      l1_globalChi2[iMuon] = -99999.;
 
       l1Charge[iMuon]           = (*muon).charge();
       l1px[iMuon]               = (*muon).px();
@@ -613,11 +444,12 @@ void ewk::SnowmassTreeProducer::analyze(const edm::Event& iEvent, const edm::Eve
   typedef edm::View<reco::GsfElectron> ElectronView;
   edm::Handle<ElectronView> electrons;
   iEvent.getByLabel( "selectedPatElectronsPFlow", electrons);
-  l2size  = (int) (electrons->size()); 
-  if( l2size > 0 ) {
-    int iElectron = 0;
+  if( electrons->size() > 0 ) {
     edm::View<reco::GsfElectron>::const_iterator electron, endpelectrons = electrons->end(); 
-    for (electron = electrons->begin();  electron != endpelectrons;  ++electron, ++iElectron) {
+    for (electron = electrons->begin();  electron != endpelectrons;  ++electron) {
+      const int iElectron = electrons_.next();
+      if (iElectron < 0) continue;
+      l2_dzPV[iElectron] = -99999.;
 
       l2Charge[iElectron]           = (*electron).charge();
       l2px[iElectron]               = (*electron).px();
@@ -673,11 +505,17 @@ void ewk::SnowmassTreeProducer::analyze(const edm::Event& iEvent, const edm::Eve
   //--------------- jet filling ----------------------------
   edm::Handle<edm::View<reco::Jet> > jets;
   iEvent.getByLabel( mInputJets, jets ); 
-  jet_size = (int) (jets->size());
-  if( jet_size > 0) {
-    int iJet = 0;
+  if( jets->size() > 0) {
     edm::View<reco::Jet>::const_iterator jet, endpjets = jets->end(); 
-    for (jet = jets->begin();  jet != endpjets;  ++jet, ++iJet) {
+    for (jet = jets->begin();  jet != endpjets;  ++jet) {
+      const int iJet = jets_.next();
+      if (iJet < 0) continue;
+      jet_bDiscriminatorSSVHE[iJet] = -99999.;
+      jet_bDiscriminatorTCHE[iJet]  = -99999.;
+      jet_bDiscriminatorCSV[iJet]   = -99999.;
+      jet_bDiscriminatorJP[iJet]    = -99999.;
+      jet_bDiscriminatorSSVHP[iJet] = -99999.;
+      jet_bDiscriminatorTCHP[iJet]  = -99999.;
 
       jet_Y[iJet]               = (*jet).rapidity();
       jet_Eta[iJet]             = (*jet).eta();
@@ -706,15 +544,8 @@ void ewk::SnowmassTreeProducer::analyze(const edm::Event& iEvent, const edm::Eve
   //--------------- photon filling ----------------------------
   edm::Handle<reco::PhotonCollection> photons;
   iEvent.getByLabel("photons",photons);
-  edm::Handle<reco::BeamSpot> bsHandle;
-  iEvent.getByLabel("offlineBeamSpot", bsHandle);
-  const reco::BeamSpot &beamspot = *bsHandle.product();
-
-  edm::Handle<reco::ConversionCollection> hConversions;
-  iEvent.getByLabel("allConversions", hConversions);
-
-  edm::Handle<reco::GsfElectronCollection> hElectrons;
-  iEvent.getByLabel("gsfElectrons", hElectrons);
+  // prompt electrons for the conversion-safe electron veto
+  electronVeto_.fill(iEvent);
 
 //   IsoDepositVals photonIsoValPFId(3);
 //   iEvent.getByLabel("phoPFIso:chIsoForGsfEle", photonIsoValPFId[0]);
@@ -723,10 +554,10 @@ void ewk::SnowmassTreeProducer::analyze(const edm::Event& iEvent, const edm::Eve
 
 //   const IsoDepositVals * photonIsoVals = &photonIsoValPFId;
 
-  photon_size = (int) (photons->size());
-  if( photon_size > 0) {
-    int iPhoton = 0;
+  if( photons->size() > 0) {
     for(unsigned ipho=0; ipho < photons->size(); ++ipho) {
+      const int iPhoton = photons_.next();
+      if (iPhoton < 0) continue;
       reco::PhotonRef myPhotonRef(photons,ipho);
       photon_px[iPhoton]  = myPhotonRef->px();
       photon_py[iPhoton]  = myPhotonRef->py();
@@ -752,7 +583,7 @@ void ewk::SnowmassTreeProducer::analyze(const edm::Event& iEvent, const edm::Eve
       if(myPhotonRef->hasPixelSeed()) photon_hasPixelSeed[iPhoton] = 1;
       else photon_hasPixelSeed[iPhoton]   = 0;
 
-      bool passConv = !(ConversionTools::hasMatchedPromptElectron(myPhotonRef->superCluster(), hElectrons, hConversions, beamspot.position()));
+      bool passConv = electronVeto_.passElectronVeto(myPhotonRef->superCluster());
       if(passConv) photon_passElecVeto[iPhoton]   = 1;
       else photon_passElecVeto[iPhoton]   = 0;
     }
@@ -763,10 +594,11 @@ void ewk::SnowmassTreeProducer::analyze(const edm::Event& iEvent, const edm::Eve
   edm::Handle<reco::TrackCollection> tracks;
   iEvent.getByLabel("generalTracks", tracks);
   reco::TrackCollection::const_iterator trk;
-  int iTracks = 0;
   if(tracks->size() > 0) {
     for ( trk = tracks->begin(); trk != tracks->end(); ++trk){
       if (fabs(trk->pt()) < 5.) continue;
+      const int iTracks = tracks_.next();
+      if (iTracks < 0) continue;
       track_px[iTracks]  = trk->px();
       track_py[iTracks]  = trk->py();
       track_pz[iTracks]  = trk->pz();
@@ -776,20 +608,19 @@ void ewk::SnowmassTreeProducer::analyze(const edm::Event& iEvent, const edm::Eve
       track_Pt[iTracks]  = trk->pt();
       track_Eta[iTracks] = trk->eta();
       track_Phi[iTracks] = trk->phi();
-      iTracks++;
     } 
   } 
-  track_size =       iTracks;
 
 
   //  ************* Load Gsf Tracks ********************
   edm::Handle<reco::GsfTrackCollection> gsftracks;
   iEvent.getByLabel("electronGsfTracks", gsftracks);
   reco::GsfTrackCollection::const_iterator gsftrk;
-  int igsf = 0;
   if(gsftracks->size() > 0) {
     for ( gsftrk = gsftracks->begin(); gsftrk != gsftracks->end(); ++gsftrk){
       if (fabs(gsftrk->pt()) < 5.) continue;
+      const int igsf = gsftracks_.next();
+      if (igsf < 0) continue;
       gsftrack_px[igsf]  = gsftrk->px();
       gsftrack_py[igsf]  = gsftrk->py();
       gsftrack_pz[igsf]  = gsftrk->pz();
@@ -799,10 +630,8 @@ void ewk::SnowmassTreeProducer::analyze(const edm::Event& iEvent, const edm::Eve
       gsftrack_Pt[igsf]  = gsftrk->pt();
       gsftrack_Eta[igsf] = gsftrk->eta();
       gsftrack_Phi[igsf] = gsftrk->phi();
-      igsf++;
     } 
   } 
-  gsftrack_size =       igsf;
 
 
 
@@ -810,10 +639,11 @@ void ewk::SnowmassTreeProducer::analyze(const edm::Event& iEvent, const edm::Eve
   edm::Handle<reco::SuperClusterCollection> superClusters;
   iEvent.getByLabel("correctedHybridSuperClusters", superClusters);
   reco::SuperClusterCollection::const_iterator sc;
-  int iSC = 0;
   if(superClusters->size() > 0) {
     for ( sc = superClusters->begin(); sc != superClusters->end(); ++sc){
       if (fabs(sc->energy()) < 5.) continue;
+      const int iSC = superClusters_.next();
+      if (iSC < 0) continue;
       superCluster_E[iSC]      = sc->energy();
       superCluster_rawE[iSC]   = sc->rawEnergy();
       superCluster_x[iSC]      = sc->x();
@@ -822,20 +652,19 @@ void ewk::SnowmassTreeProducer::analyze(const edm::Event& iEvent, const edm::Eve
       superCluster_Eta[iSC]    = sc->eta();
       superCluster_Phi[iSC]    = sc->phi();
       superCluster_nHits[iSC]  = sc->size();
-      iSC++;
     } 
   } 
-  superCluster_size = iSC;
 
 
   //  ************* Load endcap superclusters  ********************
   edm::Handle<reco::SuperClusterCollection> superClusters5x5;
   iEvent.getByLabel("correctedMulti5x5SuperClustersWithPreshower", superClusters5x5);
   reco::SuperClusterCollection::const_iterator sc5x5;
-  int iSC5x5 = 0;
   if(superClusters5x5->size() > 0) {
     for ( sc5x5 = superClusters5x5->begin(); sc5x5 != superClusters5x5->end(); ++sc5x5){
       if (fabs(sc5x5->energy()) < 5.) continue;
+      const int iSC5x5 = superClusters5x5_.next();
+      if (iSC5x5 < 0) continue;
       superCluster5x5_E[iSC5x5]      = sc5x5->energy();
       superCluster5x5_rawE[iSC5x5]   = sc5x5->rawEnergy();
       superCluster5x5_x[iSC5x5]      = sc5x5->x();
@@ -844,46 +673,42 @@ void ewk::SnowmassTreeProducer::analyze(const edm::Event& iEvent, const edm::Eve
       superCluster5x5_Eta[iSC5x5]    = sc5x5->eta();
       superCluster5x5_Phi[iSC5x5]    = sc5x5->phi();
       superCluster5x5_nHits[iSC5x5]  = sc5x5->size();
-      iSC5x5++;
     } 
   } 
-  superCluster5x5_size = iSC5x5;
 
   //  ************* Load CaloTowers  ********************
   edm::Handle<CaloTowerCollection> caloTowers;
   iEvent.getByLabel("towerMaker", caloTowers);
   CaloTowerCollection::const_iterator ct;
-  int iCT = 0;
   if(caloTowers->size() > 0) {
     for ( ct = caloTowers->begin(); ct != caloTowers->end(); ++ct){
       if (ct->hadEt()+ct->emEt() < 2.) continue;
+      const int iCT = caloTowers_.next();
+      if (iCT < 0) continue;
       caloTower_hadE [iCT]  = ct->hadEnergy();
       caloTower_emE  [iCT]  = ct->emEnergy();
       caloTower_hadEt[iCT]  = ct->hadEt();
       caloTower_emEt [iCT]  = ct->emEt();
       caloTower_Eta  [iCT]  = ct->eta();
       caloTower_Phi  [iCT]  = ct->phi();
-      iCT++;
     } 
   } 
-  caloTower_size = iCT;
   
   //  ************* Load Taus ********************
   typedef edm::View<pat::Tau> TauView;
   edm::Handle<TauView> taus;
   iEvent.getByLabel("selectedPatTausPFlow", taus);
   edm::View<pat::Tau>::const_iterator tau;
-  int iTaus = 0;
-  tau_size = (int) (taus->size());
-  if(tau_size > 0) {
+  if(taus->size() > 0) {
     for ( tau = taus->begin(); tau != taus->end(); ++tau){
+      const int iTaus = taus_.next();
+      if (iTaus < 0) continue;
       tau_px[iTaus]  = tau->px();
       tau_py[iTaus]  = tau->py();
       tau_pz[iTaus]  = tau->pz();
       tau_Pt[iTaus]  = tau->pt();
       tau_Eta[iTaus] = tau->eta();
       tau_Phi[iTaus] = tau->phi();
-      iTaus++;
     } 
   } 
 
@@ -895,11 +720,12 @@ void ewk::SnowmassTreeProducer::analyze(const edm::Event& iEvent, const edm::Eve
   //  const reco::Candidate *genPart=NULL;
   const reco::GenParticle* genPart=NULL;
 
-  genPart_size = (int) (genParticles->size());  
-  if(genPart_size > 0) {
-    for(size_t i = 0; i < genParticles->size(); ++ i) {
+  if(genParticles->size() > 0) {
+    for(size_t iGen = 0; iGen < genParticles->size(); ++ iGen) {
+      const int i = genParticles_.next();
+      if (i < 0) continue;
 
-      genPart = &((*genParticles)[i]);
+      genPart = &((*genParticles)[iGen]);
       genPart_Charge[i]           = genPart->charge();
       genPart_Vx[i]               = genPart->vx();
       genPart_Vy[i]               = genPart->vy();
@@ -921,11 +747,11 @@ void ewk::SnowmassTreeProducer::analyze(const edm::Event& iEvent, const edm::Eve
   //--------------- genjet filling ----------------------------
   edm::Handle<edm::View<reco::Jet> > genjets;
   iEvent.getByLabel( "ak5GenJets", genjets ); 
-  genjet_size = (int) (genjets->size());
-  if( genjet_size > 0) {
-    int iGenJet = 0;
+  if( genjets->size() > 0) {
     edm::View<reco::Jet>::const_iterator genjet, endpgenjets = genjets->end(); 
-    for (genjet = genjets->begin();  genjet != endpgenjets;  ++genjet, ++iGenJet) {
+    for (genjet = genjets->begin();  genjet != endpgenjets;  ++genjet) {
+      const int iGenJet = genjets_.next();
+      if (iGenJet < 0) continue;
 
       genjet_Y[iGenJet]               = (*genjet).rapidity();
       genjet_Eta[iGenJet]             = (*genjet).eta();
@@ -950,6 +776,16 @@ void ewk::SnowmassTreeProducer::analyze(const edm::Event& iEvent, const edm::Eve
 
 void ewk::SnowmassTreeProducer::endJob()
 {
+  const Block* blocks[] = { &muons_, &electrons_, &jets_, &photons_, &tracks_, &gsftracks_,
+			    &superClusters_, &superClusters5x5_, &caloTowers_, &taus_, 
+			    &genParticles_, &genjets_ };
+  for (unsigned i = 0; i < sizeof(blocks)/sizeof(blocks[0]); ++i) {
+    if (blocks[i]->totalOverflow == 0) continue;
+    std::cout << "SnowmassTreeProducer: " << blocks[i]->totalOverflow << " " 
+	      << blocks[i]->name << " entries dropped above the cap of " 
+	      << blocks[i]->cap << " per event" << std::endl;
+  }
+
 //   hOutputFile->SetCompressionLevel(2);
 //   hOutputFile->cd();
 //   tree_->Write();
@@ -983,6 +819,38 @@ void ewk::SnowmassTreeProducer::SetBranch( bool* x, std::string brName)
 }
 
 
+void ewk::SnowmassTreeProducer::SetBranch( Block& block )
+{
+  SetBranch( &block.size,      block.name+"_size" );
+  SetBranch( &block.nOverflow, block.name+"_nOverflow" );
+}
+
+
+// The buffers are sized once here and never resized afterwards, 
+// so the addresses handed to the tree stay valid for the whole job.
+void ewk::SnowmassTreeProducer::SetBranch( std::vector<float>& x, std::string brName, const Block& block )
+{
+  x.assign( block.cap, -99999. );
+  SetBranch( &x[0], brName );
+}
+
+
+void ewk::SnowmassTreeProducer::SetBranch( std::vector<int>& x, std::string brName, const Block& block )
+{
+  x.assign( block.cap, -99999 );
+  SetBranch( &x[0], brName );
+}
+
+
+void ewk::SnowmassTreeProducer::setCap( Block& block, std::string name, 
+					const edm::ParameterSet& caps, int defaultCap )
+{
+  block.name = name;
+  block.cap  = caps.existsAs<int>(name) ? caps.getParameter<int>(name) : defaultCap;
+  if (block.cap < 1) block.cap = 1;
+}
+
+
 
 //////////////////////////////////////////////////////////////////
 /////// Helper for Effective Areas ///////////////////////////////
@@ -0,0 +1,81 @@
+/*****************************************************************************
+ * Project: CMS detector at the CERN
+ *
+ * Package: ElectroWeakAnalysis/VPlusJets
+ *
+ *
+ * Authors:
+ *   A. Marini, K. Kousouris,  K. Theofilatos
+ *
+ * Description:
+ *   Per-event track -> vertex association for the jet beta/betaStar.
+ * History:
+ *
+ *****************************************************************************/
+
+#include "ElectroWeakAnalysis/VPlusJets/interface/VertexTrackMap.h"
+
+
+void ewk::VertexTrackMap::fill(const reco::VertexCollection& vertices)
+{
+  productId_ = edm::ProductID();
+  countsByKey_.clear();
+  otherCounts_.clear();
+
+  // ---- size the flat table on the collection of the first vertex track
+  unsigned int maxKey = 0;
+  for(unsigned i_vtx = 0;i_vtx < vertices.size();i_vtx++) {
+    if (vertices[i_vtx].isFake() || vertices[i_vtx].ndof() < 4) continue; 
+    for(reco::Vertex::trackRef_iterator i_vtxTrk = vertices[i_vtx].tracks_begin(); i_vtxTrk != vertices[i_vtx].tracks_end(); ++i_vtxTrk) {
+      if (productId_ == edm::ProductID()) productId_ = i_vtxTrk->id();
+      if (i_vtxTrk->id() == productId_ && i_vtxTrk->key() >= maxKey) maxKey = i_vtxTrk->key() + 1;
+    }
+  }
+  countsByKey_.assign(maxKey, std::make_pair(0,0));
+
+  // ---- record every good vertex a track belongs to -------------------
+  for(unsigned i_vtx = 0;i_vtx < vertices.size();i_vtx++) {
+    if (vertices[i_vtx].isFake() || vertices[i_vtx].ndof() < 4) continue; 
+    for(reco::Vertex::trackRef_iterator i_vtxTrk = vertices[i_vtx].tracks_begin(); i_vtxTrk != vertices[i_vtx].tracks_end(); ++i_vtxTrk) {
+      std::pair<int,int>& counts = (i_vtxTrk->id() == productId_) ? countsByKey_[i_vtxTrk->key()] 
+        : otherCounts_[std::make_pair(i_vtxTrk->id(), (unsigned int) i_vtxTrk->key())];
+      if (i_vtx == 0) counts.first++;
+      else counts.second++;
+    }
+  }
+}
+
+
+
+std::pair<int,int> ewk::VertexTrackMap::vertexCounts(const reco::TrackRef& trk) const
+{
+  if (trk.id() == productId_) {
+    if (trk.key() < countsByKey_.size()) return countsByKey_[trk.key()];
+    return std::make_pair(0,0);
+  }
+  std::map< std::pair<edm::ProductID, unsigned int>, std::pair<int,int> >::const_iterator it = 
+    otherCounts_.find(std::make_pair(trk.id(), (unsigned int) trk.key()));
+  if (it == otherCounts_.end()) return std::make_pair(0,0);
+  return it->second;
+}
+
+
+
+void ewk::VertexTrackMap::betaAndBetaStar(const reco::TrackRefVector& tracks, float& beta, float& betaStar) const
+{
+  float sumTrkPt(0.0),sumTrkPtBeta(0.0),sumTrkPtBetaStar(0.0);
+  beta = -1.0;
+  betaStar = -1.0;
+  // ---- loop over the tracks of the jet -----------------------------
+  for(reco::TrackRefVector::const_iterator i_trk = tracks.begin(); i_trk != tracks.end(); i_trk++) {
+    float pt = (*i_trk)->pt();
+    sumTrkPt += pt;
+    std::pair<int,int> counts = vertexCounts(*i_trk);
+    sumTrkPtBeta     += counts.first * pt;
+    sumTrkPtBetaStar += counts.second * pt;
+  }
+  if (sumTrkPt > 0) {
+    beta     = sumTrkPtBeta/sumTrkPt;
+    betaStar = sumTrkPtBetaStar/sumTrkPt;
+  }
+}
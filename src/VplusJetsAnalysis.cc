@@ -69,6 +69,7 @@ ewk::VplusJetsAnalysis::VplusJetsAnalysis(const edm::ParameterSet& iConfig) :
   genCA12groomedJetFiller ((iConfig.existsAs<bool>("doGroomedCA12")&& iConfig.getParameter< bool >("doGroomedCA12")&& 
 			iConfig.existsAs<bool>("runningOverMC") && iConfig.getParameter<bool>("runningOverMC")) ?
 			new GroomedJetFiller("GroomedJetFiller", myTree, "CA12", "genParticlesForJets", iConfig,1):0),
+  groomedJetParticles( iConfig ),
   GenJetFiller ( (iConfig.existsAs<bool>("runningOverMC") && 
   iConfig.getParameter<bool>("runningOverMC") && 
   iConfig.existsAs<edm::InputTag>("srcGen")) ?  
@@ -81,7 +82,8 @@ ewk::VplusJetsAnalysis::VplusJetsAnalysis(const edm::ParameterSet& iConfig) :
 					    myTree, iConfig) ),
   genBosonFiller( (iConfig.existsAs<bool>("runningOverMC") && 
   iConfig.getParameter<bool>("runningOverMC")) ?
-  new MCTreeFiller(iConfig.getParameter<std::string>("VBosonType").c_str(), myTree, iConfig) : 0)
+  new MCTreeFiller(iConfig.getParameter<std::string>("VBosonType").c_str(), myTree, iConfig) : 0),
+  fillerTimer( iConfig.existsAs<bool>("timeFillers") && iConfig.getParameter<bool>("timeFillers") )
 {
   // Are we running over Monte Carlo ?
    if( iConfig.existsAs<bool>("runningOverMC") ) 
@@ -106,6 +108,34 @@ ewk::VplusJetsAnalysis::VplusJetsAnalysis(const edm::ParameterSet& iConfig) :
   if(  iConfig.existsAs<edm::InputTag>("srcgenMet") )
 	  mInputgenMet =  iConfig.getParameter<edm::InputTag>("srcgenMet") ; 
 
+  // all groomed jet fillers read their particles from one shared cache
+  if(AK5groomedJetFiller.get()) groomedJetFillers.push_back(AK5groomedJetFiller.get());
+  if(AK7groomedJetFiller.get()) groomedJetFillers.push_back(AK7groomedJetFiller.get());
+  if(AK8groomedJetFiller.get()) groomedJetFillers.push_back(AK8groomedJetFiller.get());
+  if(CA8groomedJetFiller.get()) groomedJetFillers.push_back(CA8groomedJetFiller.get());
+  if(CA12groomedJetFiller.get()) groomedJetFillers.push_back(CA12groomedJetFiller.get());
+  if(genAK5groomedJetFiller.get()) groomedJetFillers.push_back(genAK5groomedJetFiller.get());
+  if(genAK7groomedJetFiller.get()) groomedJetFillers.push_back(genAK7groomedJetFiller.get());
+  if(genAK8groomedJetFiller.get()) groomedJetFillers.push_back(genAK8groomedJetFiller.get());
+  if(genCA8groomedJetFiller.get()) groomedJetFillers.push_back(genCA8groomedJetFiller.get());
+  if(genCA12groomedJetFiller.get()) groomedJetFillers.push_back(genCA12groomedJetFiller.get());
+  for (unsigned int i = 0; i < groomedJetFillers.size(); ++i)
+    groomedJetFillers[i]->registerInputs(groomedJetParticles);
+
+  // cost of each filler, and of the sub-steps of the groomed jet fillers
+  tGenJets             = fillerTimer.addStep("GenJetFiller");
+  tPhotons             = fillerTimer.addStep("PhotonFiller");
+  tPFCorJets           = fillerTimer.addStep("CorrectedPFJetFiller");
+  tPFCorVBFTagJets     = fillerTimer.addStep("CorrectedPFJetFillerVBFTag");
+  tGroomedJetParticles = fillerTimer.addStep("GroomedJetParticleCache");
+  for (unsigned int i = 0; i < groomedJetFillers.size(); ++i){
+    tGroomedJets.push_back( fillerTimer.addStep(groomedJetFillers[i]->name()) );
+    if (fillerTimer.enabled()) groomedJetFillers[i]->setTimer(&fillerTimer);
+  }
+  tBosonE              = fillerTimer.addStep("VtoElectronTreeFiller");
+  tBosonMu             = fillerTimer.addStep("VtoMuonTreeFiller");
+  tGenBoson            = fillerTimer.addStep("MCTreeFiller");
+  tTreeFill            = fillerTimer.addStep("TTree::Fill");
 }
 
  
@@ -225,39 +255,66 @@ void ewk::VplusJetsAnalysis::analyze(const edm::Event& iEvent,
   if( mNVB<1 ) return; // Nothing to fill
 
 
-  if(GenJetFiller.get()) GenJetFiller->fill(iEvent);
-  if(PhotonFiller.get()) PhotonFiller->fill(iEvent);
+  if(GenJetFiller.get()){
+    fillerTimer.start(tGenJets);
+    GenJetFiller->fill(iEvent);
+    fillerTimer.stop(tGenJets);
+  }
+  if(PhotonFiller.get()){
+    fillerTimer.start(tPhotons);
+    PhotonFiller->fill(iEvent);
+    fillerTimer.stop(tPhotons);
+  }
 
-  if(CorrectedPFJetFiller.get()) CorrectedPFJetFiller->fill(iEvent);
-  if(CorrectedPFJetFillerVBFTag.get()) CorrectedPFJetFillerVBFTag->fill(iEvent);//For VBF Tag Jets
+  if(CorrectedPFJetFiller.get()){
+    fillerTimer.start(tPFCorJets);
+    CorrectedPFJetFiller->fill(iEvent);
+    fillerTimer.stop(tPFCorJets);
+  }
+  if(CorrectedPFJetFillerVBFTag.get()){//For VBF Tag Jets
+    fillerTimer.start(tPFCorVBFTagJets);
+    CorrectedPFJetFillerVBFTag->fill(iEvent);
+    fillerTimer.stop(tPFCorVBFTagJets);
+  }
 
 
   /**  Store groomed jet information */
-  if(AK5groomedJetFiller.get()) AK5groomedJetFiller->fill(iEvent);
-  if(AK7groomedJetFiller.get()) AK7groomedJetFiller->fill(iEvent);
-  if(AK8groomedJetFiller.get()) AK8groomedJetFiller->fill(iEvent);
-  if(CA8groomedJetFiller.get()) CA8groomedJetFiller->fill(iEvent);
-  if(CA12groomedJetFiller.get()) CA12groomedJetFiller->fill(iEvent);
-  if(genAK5groomedJetFiller.get()) genAK5groomedJetFiller->fill(iEvent);
-  if(genAK7groomedJetFiller.get()) genAK7groomedJetFiller->fill(iEvent);
-  if(genAK8groomedJetFiller.get()) genAK8groomedJetFiller->fill(iEvent);
-  if(genCA8groomedJetFiller.get()) genCA8groomedJetFiller->fill(iEvent);
-  if(genCA12groomedJetFiller.get()) genCA12groomedJetFiller->fill(iEvent);
+  if(!groomedJetFillers.empty()){
+    fillerTimer.start(tGroomedJetParticles);
+    groomedJetParticles.fill(iEvent);
+    fillerTimer.stop(tGroomedJetParticles);
+  }
+  for (unsigned int i = 0; i < groomedJetFillers.size(); ++i){
+    fillerTimer.start(tGroomedJets[i]);
+    groomedJetFillers[i]->fill(iEvent, groomedJetParticles);
+    fillerTimer.stop(tGroomedJets[i]);
+  }
 
 
 
   /**  Store reconstructed vector boson information */
+  fillerTimer.start(tBosonE);
   recoBosonFillerE->fill(iEvent, 0);
   // if(mNVB==2) recoBosonFillerE->fill(iEvent, 1);
+  fillerTimer.stop(tBosonE);
 
+  fillerTimer.start(tBosonMu);
   recoBosonFillerMu->fill(iEvent,0);
   // if(mNVB==2) recoBosonFillerMu->fill(iEvent, 1);
+  fillerTimer.stop(tBosonMu);
 
 
   /**  Store generated vector boson information */
-  if(genBosonFiller.get()) genBosonFiller->fill(iEvent);
+  if(genBosonFiller.get()){
+    fillerTimer.start(tGenBoson);
+    genBosonFiller->fill(iEvent);
+    fillerTimer.stop(tGenBoson);
+  }
   
+  fillerTimer.start(tTreeFill);
   myTree->Fill();
+  fillerTimer.stop(tTreeFill);
+  fillerTimer.endEvent();
 
 } // analyze method
 
@@ -268,6 +325,9 @@ void ewk::VplusJetsAnalysis::analyze(const edm::Event& iEvent,
 
 void ewk::VplusJetsAnalysis::endJob()
 {
+  if (!fillerTimer.enabled()) return;
+  fillerTimer.writeSummary( fs->make<TTree>("fillerTiming", "per-event cost of the tree fillers") );
+  fillerTimer.printSummary( std::cout );
 }
 
 
@@ -106,6 +106,9 @@
 #include "SimDataFormats/GeneratorProducts/interface/GenEventInfoProduct.h"
 #include "SimDataFormats/GeneratorProducts/interface/GenRunInfoProduct.h"
 
+#include "ElectroWeakAnalysis/VPlusJets/interface/VertexTrackMap.h"
+#include "ElectroWeakAnalysis/VPlusJets/interface/EtaPhiGrid.h"
+
 //
 // class declaration
 //
@@ -223,6 +226,11 @@ class ZJetsExpress : public edm::EDAnalyzer {
       edm::Handle<edm::TriggerResults>   triggerResultsHandle_;
       edm::Handle<trigger::TriggerEvent> triggerEventHandle_;
       HLTConfigProvider hltConfig_;
+      // ---- track -> vertex association of the current event ----------
+      ewk::VertexTrackMap mVtxTrackMap;
+      // ---- pf candidates binned in eta-phi for the lepton isolation ---
+      ewk::EtaPhiGrid mPFCandGrid;
+      std::vector<unsigned int> mConeIndices;
       // ---- configurable parameters -----------------------------------
       bool          mIsMC;
       int           mMinNjets;
@@ -808,6 +816,7 @@ CCC.
   edm::Handle<VertexCollection> vertices_;
   iEvent.getByLabel("offlinePrimaryVertices", vertices_);
   const reco::Vertex *primVtx = &(*(vertices_.product()))[0];
+  mVtxTrackMap.fill(*vertices_);
   for(VertexCollection::const_iterator i_vtx = vertices_->begin(); i_vtx != vertices_->end(); ++i_vtx) {  
     if (!i_vtx->isFake() && (fabs(i_vtx->z()) < 24) && (i_vtx->ndof() >= 4)) {
       vtxZ_   ->push_back(i_vtx->z());
@@ -938,13 +947,13 @@ CCC.
   // ---- PF isolation for leptons --------------------------------------
   Handle<View<PFCandidate> > pfCandidates;
   iEvent.getByLabel("particleFlow", pfCandidates);
+  // ---- eta-phi grid of the candidates, queried once per lepton -------
+  if (myLeptons.size() > 0) mPFCandGrid.fill(*pfCandidates);
   for(unsigned il=0;il<myLeptons.size();il++) {
     float sumPt(0.0);
-    for(unsigned ipf=0;ipf<pfCandidates->size();ipf++) {
-      float dR = deltaR(myLeptons[il].p4.Eta(),myLeptons[il].p4.Phi(),(*pfCandidates)[ipf].eta(),(*pfCandidates)[ipf].phi());
-      if (dR < 0.3) {
-        sumPt += (*pfCandidates)[ipf].pt();
-      }
+    mPFCandGrid.coneIndices(myLeptons[il].p4.Eta(),myLeptons[il].p4.Phi(),0.3,mConeIndices);
+    for(unsigned ic=0;ic<mConeIndices.size();ic++) {
+      sumPt += (*pfCandidates)[mConeIndices[ic]].pt();
     }
     float isoPF = (sumPt-myLeptons[il].p4.Pt()-(*rho)*0.2827434)/myLeptons[il].p4.Pt();
     myLeptons[il].isoPF = isoPF;
@@ -1207,34 +1216,9 @@ CCC.
     // ---- jet vertex association --------------------------------------
     // ---- get the vector of tracks ------------------------------------ 
     reco::TrackRefVector vTrks(i_jet->getTrackRefs());
-    float sumTrkPt(0.0),sumTrkPtBeta(0.0),sumTrkPtBetaStar(0.0),beta(-1.0),betaStar(-1.0);
-    // ---- loop over the tracks of the jet -----------------------------
-    for(reco::TrackRefVector::const_iterator i_trk = vTrks.begin(); i_trk != vTrks.end(); i_trk++) {
-      sumTrkPt += (*i_trk)->pt();
-      // ---- loop over all vertices ------------------------------------
-      for(unsigned i_vtx = 0;i_vtx < vertices_->size();i_vtx++) {
-        // ---- loop over the tracks associated with the vertex ---------
-        if ((*vertices_)[i_vtx].isFake() || (*vertices_)[i_vtx].ndof() < 4) continue; 
-        for(reco::Vertex::trackRef_iterator i_vtxTrk = (*vertices_)[i_vtx].tracks_begin(); i_vtxTrk != (*vertices_)[i_vtx].tracks_end(); ++i_vtxTrk) {
-          // ---- match the jet track to the track from the vertex ------
-          reco::TrackRef trkRef(i_vtxTrk->castTo<reco::TrackRef>());
-          // ---- check if the tracks match -----------------------------
-          if (trkRef == (*i_trk)) {
-            if (i_vtx == 0) {
-              sumTrkPtBeta += (*i_trk)->pt();
-            }
-            else {
-              sumTrkPtBetaStar += (*i_trk)->pt();
-            }   
-            continue;
-          }
-        }
-      }// vertices loop 
-    }// jet tracks loop
-    if (sumTrkPt > 0) {
-      beta     = sumTrkPtBeta/sumTrkPt;
-      betaStar = sumTrkPtBetaStar/sumTrkPt;
-    }
+    float beta(-1.0),betaStar(-1.0);
+    // ---- one lookup per track in the event's track -> vertex map -----
+    mVtxTrackMap.betaAndBetaStar(vTrks,beta,betaStar);
     JET aJet; 
     aJet.p4       = jec * jetP4;
     aJet.jec      = jec;
@@ -0,0 +1,122 @@
+/*
+ * Heap allocation counter for FillerTimer.
+ *
+ * Preloaded into cmsRun, it counts every malloc, calloc, realloc, memalign
+ * and posix_memalign call of the process (operator new goes through malloc)
+ * and passes it on to the allocator that would have served it. FillerTimer,
+ * when enabled, finds ewkAllocationCount() and adds the per-event allocation
+ * counts of its steps to the fillerTiming tree.
+ *
+ *   gcc -O2 -shared -fPIC -o libAllocationCounter.so allocationCounter.c -ldl
+ *   env LD_PRELOAD=$PWD/libAllocationCounter.so cmsRun analysis_cfg.py
+ *
+ * An operator new replacement in the analysis library itself would not do:
+ * the libraries loaded before it, libstdc++ first, provide the one that every
+ * call resolves to, and fastjet's allocations would be missed.
+ */
+
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <stddef.h>
+#include <string.h>
+
+static unsigned long nAllocations = 0;
+
+static void* (*realMalloc)(size_t) = 0;
+static void* (*realCalloc)(size_t, size_t) = 0;
+static void* (*realRealloc)(void*, size_t) = 0;
+static void  (*realFree)(void*) = 0;
+static void* (*realMemalign)(size_t, size_t) = 0;
+static int   (*realPosixMemalign)(void**, size_t, size_t) = 0;
+
+/* dlsym may allocate while the real functions are looked up: those requests
+   are served from here and never freed */
+static char bootstrap[16384] __attribute__((aligned(16)));
+static size_t bootstrapUsed = 0;
+static int initialising = 0;
+
+static void* bootstrapAlloc(size_t size)
+{
+  void* p;
+  size = (size + 15) & ~(size_t) 15;
+  if (bootstrapUsed + size > sizeof(bootstrap)) return 0;
+  p = bootstrap + bootstrapUsed;
+  bootstrapUsed += size;
+  return p;
+}
+
+static int fromBootstrap(const void* p)
+{
+  return (const char*) p >= bootstrap && (const char*) p < bootstrap + sizeof(bootstrap);
+}
+
+static void init(void)
+{
+  if (initialising) return;
+  initialising = 1;
+  realMalloc        = (void* (*)(size_t)) dlsym(RTLD_NEXT, "malloc");
+  realCalloc        = (void* (*)(size_t, size_t)) dlsym(RTLD_NEXT, "calloc");
+  realRealloc       = (void* (*)(void*, size_t)) dlsym(RTLD_NEXT, "realloc");
+  realFree          = (void  (*)(void*)) dlsym(RTLD_NEXT, "free");
+  realMemalign      = (void* (*)(size_t, size_t)) dlsym(RTLD_NEXT, "memalign");
+  realPosixMemalign = (int   (*)(void**, size_t, size_t)) dlsym(RTLD_NEXT, "posix_memalign");
+  initialising = 0;
+}
+
+/* allocation calls so far, all threads */
+unsigned long ewkAllocationCount(void)
+{
+  return __sync_fetch_and_add(&nAllocations, 0);
+}
+
+void* malloc(size_t size)
+{
+  if (!realMalloc) init();
+  if (!realMalloc) return bootstrapAlloc(size);
+  __sync_fetch_and_add(&nAllocations, 1);
+  return realMalloc(size);
+}
+
+void* calloc(size_t n, size_t size)
+{
+  if (!realCalloc) init();
+  if (!realCalloc) return bootstrapAlloc(n*size);   /* static, so already zero */
+  __sync_fetch_and_add(&nAllocations, 1);
+  return realCalloc(n, size);
+}
+
+void* realloc(void* p, size_t size)
+{
+  if (!realRealloc) init();
+  if (fromBootstrap(p) || !realRealloc) {
+    void* q = malloc(size);
+    if (q && p) {
+      size_t left = bootstrap + sizeof(bootstrap) - (char*) p;
+      memcpy(q, p, size < left ? size : left);
+    }
+    return q;
+  }
+  __sync_fetch_and_add(&nAllocations, 1);
+  return realRealloc(p, size);
+}
+
+void free(void* p)
+{
+  if (!p || fromBootstrap(p)) return;
+  if (!realFree) init();
+  realFree(p);
+}
+
+void* memalign(size_t alignment, size_t size)
+{
+  if (!realMemalign) init();
+  __sync_fetch_and_add(&nAllocations, 1);
+  return realMemalign(alignment, size);
+}
+
+int posix_memalign(void** p, size_t alignment, size_t size)
+{
+  if (!realPosixMemalign) init();
+  __sync_fetch_and_add(&nAllocations, 1);
+  return realPosixMemalign(p, alignment, size);
+}
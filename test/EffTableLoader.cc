@@ -27,35 +27,40 @@ int EffTableLoader::GetBandIndex(float fEt, float fEta)const {
 }
 std::vector<float> EffTableLoader::GetEfficiencyAndError (float fEt,float fEta) const {
   int index=mParameters->bandIndex(fEt, fEta);
-  EffTableReader::Record rec=mParameters->record(index);
-  std::vector<float> param=rec.parameters();
-  return param;
+  return mParameters->record(index).parameters();
 }
 std::vector<float> EffTableLoader::GetEfficiencyAndError (int index) const {
-  EffTableReader::Record rec=mParameters->record(index);
-  std::vector<float> param=rec.parameters();
-  return param;
+  return mParameters->record(index).parameters();
 }
 
 
 float EffTableLoader::GetEfficiency (float fEt,float fEta) const {
-   std::vector<float> param = GetEfficiencyAndError (fEt, fEta);
-   return param[0];
+   return mParameters->record(mParameters->bandIndex(fEt, fEta)).parameter(0);
 }
 
 float EffTableLoader::GetError (float fEt,float fEta) const {
-   std::vector<float> param = GetEfficiencyAndError (fEt, fEta);
-   return param[1];
+   return mParameters->record(mParameters->bandIndex(fEt, fEta)).parameter(1);
 }
 
 float EffTableLoader::GetEfficiency (int index) const {
-   std::vector<float> param = GetEfficiencyAndError (index);
-   return param[0];
+   return mParameters->record(index).parameter(0);
 }
 
 float EffTableLoader::GetError (int index) const {
-   std::vector<float> param = GetEfficiencyAndError (index);
-   return param[1];
+   return mParameters->record(index).parameter(1);
+}
+
+std::pair<float, float> EffTableLoader::GetEfficiencyWithError (float fEt,float fEta) const {
+   const EffTableReader::Record& rec = mParameters->record(mParameters->bandIndex(fEt, fEta));
+   return std::make_pair(rec.parameter(0), rec.parameter(1));
+}
+
+void EffTableLoader::GetEfficiencies (unsigned n, const float* fEt, const float* fEta, float* eff, float* err) const {
+   for (unsigned i = 0; i < n; ++i) {
+      const EffTableReader::Record& rec = mParameters->record(mParameters->bandIndex(fEt[i], fEta[i]));
+      eff[i] = rec.parameter(0);
+      if (err) err[i] = rec.parameter(1);
+   }
 }
 
 
@@ -18,6 +18,10 @@ public:
   float GetError (float fEt,float fEta) const;
   float GetEfficiency (int index) const;
   float GetError (int index) const;
+  /// efficiency (first) and error (second), without allocating
+  std::pair<float, float> GetEfficiencyWithError (float fEt, float fEta) const;
+  /// efficiencies, and errors if err is not null, for n (Et, eta) pairs
+  void GetEfficiencies (unsigned n, const float* fEt, const float* fEta, float* eff, float* err = 0) const;
 
   int GetBandIndex(float fEt, float fEta) const;
   std::vector<std::pair<float, float> > GetCellInfo(int index)const;
@@ -10,6 +10,7 @@
 #include <ctype.h>
 #include <fstream>
 #include <stdlib.h>
+#include <algorithm>
 
 namespace {
   float getFloat (const std::string& token) {
@@ -102,29 +103,48 @@ EffTableReader::EffTableReader (const std::string& fFile) {
     }
   }
   if (mRecords.empty()) mRecords.push_back (Record ());
-
+  buildGrid ();
 }
 
 
-int EffTableReader::bandIndex (float fEt, float fEta) const{
-  int bandInd =0;
-  // std::cout << '\n';
-  // std::cout << "finding band for: " << fEt << ", " << fEta << '\n';
-  // std::cout << &mRecords << ":" << mRecords.size();
+void EffTableReader::buildGrid () {
   for (unsigned i = 0; i < mRecords.size(); ++i) {
-    // std::cout << "record " << i ;
-    // std::cout << " Et: " << mRecords[i].EtMin() << '-' << mRecords[i].EtMax()
-    // 	      << " eta: " << mRecords[i].etaMin() << '-' << mRecords[i].etaMax()
-    // 	      << '\n';
-    if(fEt>=mRecords[i].EtMin() && fEt<mRecords[i].EtMax()){
-      if(fEta>=mRecords[i].etaMin() && fEta<mRecords[i].etaMax()){
-	bandInd=i;
-	break;                        
-      }
-    }
-    
+    mEtEdges.push_back (mRecords[i].EtMin());
+    mEtEdges.push_back (mRecords[i].EtMax());
+    mEtaEdges.push_back (mRecords[i].etaMin());
+    mEtaEdges.push_back (mRecords[i].etaMax());
+  }
+  std::sort (mEtEdges.begin(), mEtEdges.end());
+  mEtEdges.erase (std::unique (mEtEdges.begin(), mEtEdges.end()), mEtEdges.end());
+  std::sort (mEtaEdges.begin(), mEtaEdges.end());
+  mEtaEdges.erase (std::unique (mEtaEdges.begin(), mEtaEdges.end()), mEtaEdges.end());
+
+  // every record boundary is an edge, so a record either covers a cell
+  // completely or not at all; the first record wins, as in the scan
+  const unsigned nEt = mEtEdges.size() - 1, nEta = mEtaEdges.size() - 1;
+  mCellBand.assign (nEt*nEta, -1);
+  for (unsigned i = mRecords.size(); i-- > 0; ) {
+    const Record& rec = mRecords[i];
+    unsigned et0 = std::lower_bound (mEtEdges.begin(), mEtEdges.end(), rec.EtMin()) - mEtEdges.begin();
+    unsigned et1 = std::lower_bound (mEtEdges.begin(), mEtEdges.end(), rec.EtMax()) - mEtEdges.begin();
+    unsigned eta0 = std::lower_bound (mEtaEdges.begin(), mEtaEdges.end(), rec.etaMin()) - mEtaEdges.begin();
+    unsigned eta1 = std::lower_bound (mEtaEdges.begin(), mEtaEdges.end(), rec.etaMax()) - mEtaEdges.begin();
+    for (unsigned iEt = et0; iEt < et1; ++iEt)
+      for (unsigned iEta = eta0; iEta < eta1; ++iEta)
+        mCellBand[iEt*nEta + iEta] = i;
   }
-  return bandInd;
+}
+
+
+int EffTableReader::bandIndex (float fEt, float fEta) const{
+  // cell iEt holds mEtEdges[iEt] <= fEt < mEtEdges[iEt+1]; outside the
+  // table, or in a cell no record covers, fall back to band 0
+  int iEt = std::upper_bound (mEtEdges.begin(), mEtEdges.end(), fEt) - mEtEdges.begin() - 1;
+  int iEta = std::upper_bound (mEtaEdges.begin(), mEtaEdges.end(), fEta) - mEtaEdges.begin() - 1;
+  const int nEt = mEtEdges.size() - 1, nEta = mEtaEdges.size() - 1;
+  if (iEt < 0 || iEt >= nEt || iEta < 0 || iEta >= nEta) return 0;
+  const int bandInd = mCellBand[iEt*nEta + iEta];
+  return bandInd < 0 ? 0 : bandInd;
 }
 
 
@@ -47,7 +47,14 @@ class EffTableReader {
   /// get record for the band 
   const Record& record (unsigned fBand) const {return mRecords[fBand];}
   private:
+  /// sorted Et and eta edges of all records, and for every cell between
+  /// them the first record covering it (-1 if none), so that bandIndex is
+  /// two binary searches instead of a scan over the records
+  void buildGrid ();
   std::vector <Record> mRecords;
+  std::vector <float> mEtEdges;
+  std::vector <float> mEtaEdges;
+  std::vector <int> mCellBand;
 };
 
 #endif
@@ -8,6 +8,7 @@
 #include "TRandom3.h"
 #include "TMath.h"
 #include "TTreeFormula.h"
+#include "TBranch.h"
 
 #ifndef __CINT__
 #include "RooGlobalFunc.h"
@@ -144,135 +145,184 @@ TH1 * RooWjjFitterUtils::File2Hist(TString fname,
 				   int jes_scl, bool noCuts, 
 				   int binMult, TString cutOverride,
 				   bool CPweights, int interfereWgt) const {
+  HistBooking booking = { fname, histName, isElectron, jes_scl, noCuts, 
+			  binMult, cutOverride, CPweights, interfereWgt };
+  return fillHists(std::vector<HistBooking>(1, booking))[0];
+}
+
+unsigned int RooWjjFitterUtils::bookHist(TString fname, 
+					 TString histName, bool isElectron,
+					 int jes_scl, bool noCuts, 
+					 int binMult, TString cutOverride,
+					 bool CPweights, int interfereWgt) {
+  HistBooking booking = { fname, histName, isElectron, jes_scl, noCuts, 
+			  binMult, cutOverride, CPweights, interfereWgt };
+  bookings_.push_back(booking);
+  return bookings_.size()-1;
+}
+
+std::vector<TH1 *> RooWjjFitterUtils::fillBookedHists() {
+  std::vector<TH1 *> hists = fillHists(bookings_);
+  bookings_.clear();
+  return hists;
+}
+
+std::vector<TH1 *> 
+RooWjjFitterUtils::fillHists(std::vector<HistBooking> const& bookings) const {
+  std::vector<TH1 *> hists(bookings.size(), (TH1 *)0);
+  std::vector<bool> done(bookings.size(), false);
+  for (unsigned int first = 0; first < bookings.size(); ++first) {
+    if (done[first]) continue;
+    std::vector<unsigned int> inFile;
+    for (unsigned int i = first; i < bookings.size(); ++i)
+      if (!done[i] && (bookings[i].fname == bookings[first].fname)) {
+	inFile.push_back(i);
+	done[i] = true;
+      }
+    fillHistsFromFile(bookings[first].fname, bookings, inFile, hists);
+  }
+  return hists;
+}
+
+void RooWjjFitterUtils::fillHistsFromFile(TString fname, 
+					  std::vector<HistBooking> const& bookings,
+					  std::vector<unsigned int> const& inFile,
+					  std::vector<TH1 *>& hists) const {
   TFile * treeFile = TFile::Open(fname);
-  TTree * theTree;
-  treeFile->GetObject(params_.treeName, theTree);
+  TTree * theTree = 0;
+  if (treeFile)
+    treeFile->GetObject(params_.treeName, theTree);
   if (!theTree) {
     std::cout << "failed to find tree " << params_.treeName << " in file " << fname 
 	      << '\n';
-    return 0;
+    delete treeFile;
+    return;
   }
 
-  double tmpScale = 0.;
-  if ((jes_scl >= 0) && (jes_scl < int(params_.JES_scales.size())))
-    tmpScale = params_.JES_scales[jes_scl];
-//   TString plotStr = TString::Format("%s*(1+%0.4f)", params_.var.Data(), 
-// 				    tmpScale);
-  TH1 * theHist = newEmptyHist(histName, binMult);
-
-  TString theCuts(cutOverride);
-  if (theCuts.Length() < 1)
-    theCuts = fullCuts();
-  else
-    std::cout << histName << " cuts: " << theCuts << '\n';
-  theTree->Draw(">>" + histName + "_evtList", 
-		((noCuts) ? TString("") : theCuts),
-		"goff");
-  TEventList * list = (TEventList *)gDirectory->Get(histName + "_evtList");
+  // one compiled formula per distinct cut string, shared by the bookings;
+  // the formulas read only the branches they use, entry by entry
+  std::vector<TString> cutStrings;
+  std::vector<TTreeFormula *> cuts;
+  std::vector<int> cutIndex(inFile.size(), -1);
+  std::vector<double> scales(inFile.size(), 0.);
+  std::vector<bool> doWeights(inFile.size(), false);
+  bool anyWeights = false, anyCP = false, anyUncut = false;
+  bool needInterference[4] = { false, false, false, false };
+
+  unsigned int b, c;
+  for (b = 0; b < inFile.size(); ++b) {
+    HistBooking const& booking = bookings[inFile[b]];
+    if ((booking.jes_scl >= 0) && 
+	(booking.jes_scl < int(params_.JES_scales.size())))
+      scales[b] = params_.JES_scales[booking.jes_scl];
+    hists[inFile[b]] = newEmptyHist(booking.histName, booking.binMult);
+    hists[inFile[b]]->SetDirectory(0);
+
+    TString theCuts(booking.cutOverride);
+    if (theCuts.Length() < 1)
+      theCuts = fullCuts();
+    else
+      std::cout << booking.histName << " cuts: " << theCuts << '\n';
+    if (booking.noCuts)
+      theCuts = "";
+
+    if (theCuts.Length() > 0) {
+      for (c = 0; (c < cutStrings.size()) && (cutStrings[c] != theCuts); ++c) ;
+      if (c == cutStrings.size()) {
+	cutStrings.push_back(theCuts);
+	cuts.push_back(new TTreeFormula(TString::Format("cut%i", c), 
+					theCuts, theTree));
+      }
+      cutIndex[b] = c;
+    } else
+      anyUncut = true;
+
+    doWeights[b] = params_.doEffCorrections && (!booking.noCuts) && 
+      (booking.cutOverride.Length() < 1);
+    if (!doWeights[b])
+      std::cout << "no weighting of histogram " << booking.histName << '\n';
+    anyWeights = anyWeights || doWeights[b];
+    anyCP = anyCP || (booking.CPweights && (params_.mHiggs > 0));
+    if ((booking.interfereWgt > 0) && (booking.interfereWgt < 4))
+      needInterference[booking.interfereWgt] = true;
+  }
 
-  bool localDoWeights = params_.doEffCorrections && (!noCuts) && 
-    (cutOverride.Length() < 1);
+  TTreeFormula poi("poi", params_.var, theTree);
 
-  if (!localDoWeights)
-    std::cout << "no weighting of histogram " << histName << '\n';
-  //static unsigned int const maxJets = 6;
-  activateBranches(*theTree, isElectron);
-  Float_t         JetPFCor_Pt[maxJets];
-  Float_t         JetPFCor_Eta[maxJets];
-  Float_t         Mass2j_PFCor;
-  Float_t         MassV2j_PFCor;
-  Float_t         event_met_pfmet;
-  Int_t           event_nPV;
-  //Int_t           evtNJ;
-  Float_t         lepton_pt;
-  Float_t         lepton_eta;
-  Float_t         W_mt;
   Float_t         W_H_mass_gen;
-  Float_t         interferencewt(1.0);
+  Float_t         interferencewt[4] = { 1.0, 1.0, 1.0, 1.0 };
   Float_t effwt;
   Float_t puwt;
+  TBranch * effwtBranch = 0, * puwtBranch = 0, * massGenBranch = 0;
+  TBranch * interferenceBranch[4] = { 0, 0, 0, 0 };
 
-  TTreeFormula poi("poi", params_.var, theTree);
-
-  theTree->SetBranchAddress("Mass2j_PFCor", &Mass2j_PFCor);
-  theTree->SetBranchAddress("MassV2j_PFCor", &MassV2j_PFCor);
-
-//   int PoiMatch = theTree->SetBranchAddress(params_.var, &poi);
-//   bool goodPoi = true;
-//   if (PoiMatch != 0) goodPoi = false;
-
-  if (localDoWeights) {
-    theTree->SetBranchAddress("JetPFCor_Pt",JetPFCor_Pt);
-    theTree->SetBranchAddress("JetPFCor_Eta",JetPFCor_Eta);
-    theTree->SetBranchAddress("event_nPV", &event_nPV);
-    theTree->SetBranchAddress("event_met_pfmet", &event_met_pfmet);
-    //theTree->SetBranchAddress("ggdevt", &evtNJ);
-    if(isElectron) {
-      theTree->SetBranchAddress("W_electron_pt", &lepton_pt);
-      theTree->SetBranchAddress("W_electron_eta", &lepton_eta);
-    } else {
-      theTree->SetBranchAddress("W_muon_pt", &lepton_pt);
-      theTree->SetBranchAddress("W_muon_eta", &lepton_eta);
-    }
-    theTree->SetBranchAddress("W_mt", &W_mt);
-    theTree->SetBranchAddress("effwt", &effwt);
-    theTree->SetBranchAddress("puwt", &puwt);
-  }
-
-  if (CPweights)
-    theTree->SetBranchAddress("W_H_mass_gen", &W_H_mass_gen);
-
-  switch (interfereWgt) {
-  case 1:
-    theTree->SetBranchAddress(TString::Format("interferencewtggH%i", 
-					      int(params_.mHiggs)),
-			      &interferencewt);
-    break;
-  case 2:
-    theTree->SetBranchAddress(TString::Format("interferencewt_upggH%i", 
-					      int(params_.mHiggs)),
-			      &interferencewt);
-    break;
-  case 3:
-    theTree->SetBranchAddress(TString::Format("interferencewt_downggH%i", 
-					      int(params_.mHiggs)),
-			      &interferencewt);
-    break;
+  if (anyWeights) {
+    theTree->SetBranchAddress("effwt", &effwt, &effwtBranch);
+    theTree->SetBranchAddress("puwt", &puwt, &puwtBranch);
   }
-
-//   static TRandom3 rnd(987654321);
-//   double epochSelector = rnd.Rndm(), sumLumi = 0.;
-//   int lumiSize = (isElectron) ? params_.lumiPerEpochElectron.size() :
-//     params_.lumiPerEpochMuon.size();
-//   int epoch = -1;
-  double evtWgt = 1.0/*, hltEffJets = 1.0, hltEffMHT = 1.0*/;
-//   std::vector<double> eff30(maxJets), eff25n30(maxJets);
-  for (int event = 0; event < list->GetN(); ++event) {
-    theTree->GetEntry(list->GetEntry(event));
-    evtWgt = 1.0;
-    if (localDoWeights) {
-      // evtWgt = effWeight(lepton_pt, lepton_eta, W_mt, JetPFCor_Pt,
-      // 			 JetPFCor_Eta, params_.njets, event_met_pfmet,
-      // 			 isElectron);
-      evtWgt = effwt*puwt;
-    }
-    if ((CPweights) && (params_.mHiggs > 0)) {
-      evtWgt *= getCPweight(params_.mHiggs, params_.wHiggs, W_H_mass_gen);
+  if (anyCP)
+    theTree->SetBranchAddress("W_H_mass_gen", &W_H_mass_gen, &massGenBranch);
+  char const * interferenceNames[4] = { "", "interferencewtggH%i", 
+					"interferencewt_upggH%i", 
+					"interferencewt_downggH%i" };
+  for (int i = 1; i < 4; ++i)
+    if (needInterference[i])
+      theTree->SetBranchAddress(TString::Format(interferenceNames[i], 
+						int(params_.mHiggs)),
+				&interferencewt[i], &interferenceBranch[i]);
+
+  // an entry passes a cut if any instance of the formula is non-zero, 
+  // as for the event lists of TTree::Draw
+  std::vector<char> passed(cuts.size(), 0);
+  double evtWgt = 1.0;
+  Long64_t nEntries = theTree->GetEntries();
+  for (Long64_t entry = 0; entry < nEntries; ++entry) {
+    Long64_t localEntry = theTree->LoadTree(entry);
+    bool anyPassed = anyUncut;
+    for (c = 0; c < cuts.size(); ++c) {
+      passed[c] = 0;
+      int ndata = cuts[c]->GetNdata();
+      for (int i = 0; (i < ndata) && (!passed[c]); ++i)
+	if (cuts[c]->EvalInstance(i) != 0)
+	  passed[c] = 1;
+      anyPassed = anyPassed || passed[c];
     }
-    if (interfereWgt) {
-      evtWgt *= interferencewt;
+    if (!anyPassed) continue;
+
+    poi.GetNdata();
+    double var = poi.EvalInstance(0);
+    if (effwtBranch) effwtBranch->GetEntry(localEntry);
+    if (puwtBranch) puwtBranch->GetEntry(localEntry);
+    if (massGenBranch) massGenBranch->GetEntry(localEntry);
+    for (int i = 1; i < 4; ++i)
+      if (interferenceBranch[i]) interferenceBranch[i]->GetEntry(localEntry);
+
+    for (b = 0; b < inFile.size(); ++b) {
+      if ((cutIndex[b] >= 0) && (!passed[cutIndex[b]])) continue;
+      HistBooking const& booking = bookings[inFile[b]];
+      evtWgt = 1.0;
+      if (doWeights[b]) {
+	// evtWgt = effWeight(lepton_pt, lepton_eta, W_mt, JetPFCor_Pt,
+	// 			 JetPFCor_Eta, params_.njets, event_met_pfmet,
+	// 			 booking.isElectron);
+	evtWgt = effwt*puwt;
+      }
+      if ((booking.CPweights) && (params_.mHiggs > 0)) {
+	evtWgt *= getCPweight(params_.mHiggs, params_.wHiggs, W_H_mass_gen);
+      }
+      if ((booking.interfereWgt > 0) && (booking.interfereWgt < 4)) {
+	evtWgt *= interferencewt[booking.interfereWgt];
+      }
+      hists[inFile[b]]->Fill(var*(1.+scales[b]), evtWgt);
     }
-    theHist->Fill(poi.EvalInstance()*(1.+tmpScale), evtWgt);
   }
 
+  for (c = 0; c < cuts.size(); ++c)
+    delete cuts[c];
+  theTree->ResetBranchAddresses();
   delete theTree;
 
-  theHist->SetDirectory(0);
-
   delete treeFile;
-
-  //theHist->Print();
-  return theHist;
 }
 
 RooAbsPdf * RooWjjFitterUtils::Hist2Pdf(TH1 * hist, TString pdfName,
@@ -37,6 +37,27 @@ public:
 		  int jes_scl = -1, bool noCuts = false, 
 		  int binMult = 1, TString cutOverride = "",
 		  bool CPweights = false, int interfereWgt = 0) const;
+  /// One histogram request: the arguments of File2Hist
+  struct HistBooking {
+    TString fname;
+    TString histName;
+    bool isElectron;
+    int jes_scl;
+    bool noCuts;
+    int binMult;
+    TString cutOverride;
+    bool CPweights;
+    int interfereWgt;
+  };
+  /// book a histogram, with the arguments of File2Hist; returns its index
+  /// in the result of the next fillBookedHists
+  unsigned int bookHist(TString fname, TString histName, bool isElectron, 
+			int jes_scl = -1, bool noCuts = false, 
+			int binMult = 1, TString cutOverride = "",
+			bool CPweights = false, int interfereWgt = 0);
+  /// fill all booked histograms, reading each input file once, and clear 
+  /// the bookings; histograms from files without the tree are null
+  std::vector<TH1 *> fillBookedHists();
   RooAbsPdf * Hist2Pdf(TH1 * hist, TString pdfName, 
 		       RooWorkspace& ws, int order = 0,
 		       bool fast = true) const;
@@ -70,6 +91,11 @@ protected:
   void initialize();
 
   void updatenjets();
+  std::vector<TH1 *> fillHists(std::vector<HistBooking> const& bookings) const;
+  void fillHistsFromFile(TString fname, 
+			 std::vector<HistBooking> const& bookings,
+			 std::vector<unsigned int> const& inFile,
+			 std::vector<TH1 *>& hists) const;
   static double sig2(RooAddPdf& pdf, RooRealVar& obs, double Nbin);
   static double sig2(RooHistPdf& pdf, RooRealVar& obs, double Nbin);
 
@@ -87,6 +113,8 @@ protected:
   std::vector<EffTableLoader*> effJ30, effJ25NoJ30;
   std::vector<EffTableLoader*> effMHT;
   std::vector<EffTableLoader*> effEleWMt;
+
+  std::vector<HistBooking> bookings_;
   
 };
 
@@ -2118,31 +2118,32 @@ TH1 * RooWjjMjjFitter::getWpJHistFromData(TString histName, double alpha,
   TH1 * th1wpjHi = utils_.newEmptyHist(histName + "_Hi");
   TH1 * th1wpjLo = utils_.newEmptyHist(histName + "_Lo");
 
-  TH1 * tmpHist;
+  // both sidebands from one pass over each data file
+  std::vector<TH1 *> hiHists, loHists;
+  std::vector<unsigned int> hiIdx, loIdx;
   if (params_.includeMuons) {
-    tmpHist = utils_.File2Hist(params_.DataDirectory + params_.muonData, 
-			       histName + "_Hi_mu", false, 1, false, 1, 
-			       cutsSBHi);
-    th1wpjHi->Add(tmpHist);
-    delete tmpHist;
-    tmpHist = utils_.File2Hist(params_.DataDirectory + params_.muonData, 
-			       histName + "_Lo_mu", false, 1, false, 1, 
-			       cutsSBLo);
-    th1wpjLo->Add(tmpHist);
-    delete tmpHist;
+    hiIdx.push_back(utils_.bookHist(params_.DataDirectory + params_.muonData, 
+				    histName + "_Hi_mu", false, 1, false, 1, 
+				    cutsSBHi));
+    loIdx.push_back(utils_.bookHist(params_.DataDirectory + params_.muonData, 
+				    histName + "_Lo_mu", false, 1, false, 1, 
+				    cutsSBLo));
   }
   if (params_.includeElectrons) {
-    tmpHist = utils_.File2Hist(params_.DataDirectory + params_.electronData, 
-			       histName + "_Hi_el", true, 1, false, 1, 
-			       cutsSBHi);
-    th1wpjHi->Add(tmpHist);
-    delete tmpHist;
-    tmpHist = utils_.File2Hist(params_.DataDirectory + params_.electronData, 
-			       histName + "_Lo_el", true, 1, false, 1, 
-			       cutsSBLo);
-    th1wpjLo->Add(tmpHist);
-    delete tmpHist;
+    hiIdx.push_back(utils_.bookHist(params_.DataDirectory + params_.electronData, 
+				    histName + "_Hi_el", true, 1, false, 1, 
+				    cutsSBHi));
+    loIdx.push_back(utils_.bookHist(params_.DataDirectory + params_.electronData, 
+				    histName + "_Lo_el", true, 1, false, 1, 
+				    cutsSBLo));
+  }
+  std::vector<TH1 *> sbHists = utils_.fillBookedHists();
+  for (unsigned int i = 0; i < hiIdx.size(); ++i) {
+    th1wpjHi->Add(sbHists[hiIdx[i]]);
+    th1wpjLo->Add(sbHists[loIdx[i]]);
   }
+  for (unsigned int i = 0; i < sbHists.size(); ++i)
+    delete sbHists[i];
 
 //   th1wpjHi->Print();
 //   th1wpjHi->Draw();
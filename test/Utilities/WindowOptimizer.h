@@ -0,0 +1,161 @@
+#ifndef WindowOptimizer_h
+#define WindowOptimizer_h
+
+// ====================================================================================
+// Window optimisation on binned signal and background shapes.
+//
+// The histograms are turned into cumulative sums once, so the yield of any
+// window of bins costs two lookups instead of a TH1::Integral call, and a
+// scan of all windows is O(nbin^2).
+// 2D histograms add a one-sided cut on x (e.g. an MVA output, keeping x bins
+// >= the threshold bin) on top of the window on y; 1D histograms are the
+// case of a single x bin. Under- and overflow bins are not included, as in
+// TH1::Integral(lo, hi).
+//
+// Windows are indexed like the scan in MakePlot: (lo, hi) with
+// 0 <= lo < hi <= nbin covers the bins lo+1 ... hi.
+// ====================================================================================
+
+#include <cmath>
+#include <vector>
+
+#include "TH1.h"
+#include "TH2.h"
+
+class WindowOptimizer {
+public:
+
+  /// which windows a scan considers
+  enum ScanType {
+    kAllWindows = 0,  ///< any lo < hi
+    kLowerCut   = 1,  ///< hi fixed at the last bin
+    kUpperCut   = 2,  ///< lo fixed at the first bin
+    kSymmetric  = 3   ///< lo == nbin - hi
+  };
+
+  /// sysFrac is the relative background systematic in S/sqrt(B + (sysFrac*B)^2)
+  explicit WindowOptimizer(double sysFrac = 0.) :
+    sysFrac_(sysFrac), nx_(0), ny_(0), signal_(0), background_(1) {}
+
+  /// add a sample; all samples must have the same binning. Returns its index.
+  unsigned int add(const TH1 * h) {
+    if (h->GetDimension() == 2) return addBins(h, h->GetNbinsX(), h->GetNbinsY());
+    return addBins(h, 1, h->GetNbinsX());
+  }
+
+  void setSignal(unsigned int k)     { signal_ = k; }
+  void setBackground(unsigned int k) { background_ = k; }
+
+  int nBinsCut() const    { return nx_; }
+  int nBinsWindow() const { return ny_; }
+
+  /// yield of sample k in the window, after the cut on x at bin cut+1
+  double integral(unsigned int k, int lo, int hi, int cut = 0) const {
+    const std::vector<double> & sums = cumulative_[k];
+    return sums[index(cut, hi)] - sums[index(cut, lo)];
+  }
+
+  /// fraction of sample k (with no cut) inside the window and cut
+  double efficiency(unsigned int k, int lo, int hi, int cut = 0) const {
+    const double total = integral(k, 0, ny_, 0);
+    return total != 0. ? integral(k, lo, hi, cut)/total : 0.;
+  }
+
+  double significance(int lo, int hi, int cut = 0) const {
+    const double s = integral(signal_, lo, hi, cut);
+    const double b = integral(background_, lo, hi, cut);
+    if (b == 0.) return 0.;
+    return s/std::sqrt(b + sysFrac_*sysFrac_*b*b);
+  }
+
+  bool allowed(int type, int lo, int hi) const {
+    switch (type) {
+    case kLowerCut: return hi == ny_;
+    case kUpperCut: return lo == 0;
+    case kSymmetric: return lo == ny_ - hi;
+    default: return true;
+    }
+  }
+
+  /// Best significance among the windows of the given type whose signal
+  /// efficiency is above minSigEff, scanning the x cuts too if the samples
+  /// are 2D. The first of equal maxima in (cut, lo, hi) order is kept.
+  /// Returns false, leaving lo/hi/cut untouched, if no window qualifies.
+  bool scan(int type, double minSigEff, int & bestLo, int & bestHi,
+	    int * bestCut = 0) const {
+    double best = -999.;
+    bool found = false;
+    for (int cut = 0; cut < nx_; cut++) {
+      for (int lo = 0; lo < ny_; lo++) {
+	// the signal efficiency grows with hi when the signal has no negative
+	// bins, so the windows below the efficiency threshold can be skipped
+	int hi = lo+1;
+	if (monotone_[signal_]) {
+	  hi = firstAboveEfficiency(lo, cut, minSigEff);
+	  // and it only drops when lo moves up
+	  if (hi > ny_) break;
+	}
+	for (; hi <= ny_; hi++) {
+	  if (!allowed(type, lo, hi)) continue;
+	  if (efficiency(signal_, lo, hi, cut) <= minSigEff) continue;
+	  const double sig = significance(lo, hi, cut);
+	  if (sig > best) {
+	    best = sig;
+	    bestLo = lo;
+	    bestHi = hi;
+	    if (bestCut) *bestCut = cut;
+	    found = true;
+	  }
+	}
+      }
+    }
+    return found;
+  }
+
+private:
+
+  unsigned int addBins(const TH1 * h, int nx, int ny) {
+    if (cumulative_.empty()) {
+      nx_ = nx;
+      ny_ = ny;
+    }
+    // sums[index(cut, j)] = content of x bins >= cut+1 and y bins <= j
+    std::vector<double> sums(nx_*(ny_+1), 0.);
+    bool nonNegative = true;
+    const bool is2D = (h->GetDimension() == 2);
+    for (int ix = nx_-1; ix >= 0; ix--) {
+      for (int jy = 1; jy <= ny_; jy++) {
+	const double content = is2D ? h->GetBinContent(ix+1, jy) : h->GetBinContent(jy);
+	if (content < 0.) nonNegative = false;
+	double above = 0.;
+	if (ix+1 < nx_) above = sums[index(ix+1, jy)] - sums[index(ix+1, jy-1)];
+	sums[index(ix, jy)] = sums[index(ix, jy-1)] + above + content;
+      }
+    }
+    cumulative_.push_back(sums);
+    monotone_.push_back(nonNegative);
+    return cumulative_.size()-1;
+  }
+
+  int index(int cut, int j) const { return cut*(ny_+1) + j; }
+
+  /// smallest hi > lo with the signal efficiency above minSigEff,
+  /// ny_+1 if there is none; only valid for non-negative signal
+  int firstAboveEfficiency(int lo, int cut, double minSigEff) const {
+    int first = lo+1, last = ny_+1;
+    while (first < last) {
+      const int mid = (first+last)/2;
+      if (efficiency(signal_, lo, mid, cut) > minSigEff) last = mid;
+      else first = mid+1;
+    }
+    return first;
+  }
+
+  double sysFrac_;
+  int nx_, ny_;
+  unsigned int signal_, background_;
+  std::vector<std::vector<double> > cumulative_;
+  std::vector<bool> monotone_;
+};
+
+#endif
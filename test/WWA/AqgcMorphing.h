@@ -0,0 +1,256 @@
+#ifndef AqgcMorphing_h
+#define AqgcMorphing_h
+
+/*//////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+Per-bin parameterisation of the anomalous-coupling signal.
+
+Takes the ratio to the SM of the distribution at N coupling points
+(1D, or a 2D grid of two couplings) and fits, bin by bin, the ratio
+with a polynomial in the coupling(s):
+
+   1D, degree 2:  p0 + p1*x + p2*x^2
+   2D, degree 2:  p0 + p1*x + p2*y + p3*x^2 + p4*x*y + p5*y^2
+
+The least-squares fit is linear in the parameters and is solved in
+closed form from the normal equations; the couplings are rescaled to
+O(1) internally. With uniform errors the design matrix is the same for
+every bin and is inverted once for all bins. The default errors are
+sqrt(ratio), which is what TH1::Fit used on the unweighted "bin_N"
+histograms of the mkROOTaqgc*_Para macros; points with a zero ratio are
+then left out of the fit of that bin, as TH1::Fit did.
+
+Usage:
+   AqgcMorphing morph(2);
+   morph.addPoint(-5E-5, signal_m50);   // ratio histograms to the SM
+   morph.addSMPoint();                  // ratio 1 at zero coupling
+   morph.addPoint( 5E-5, signal_50);
+   morph.fit();
+   TH1* p0 = morph.parameterHist(0, "p0", "Parameter 0");
+
+///////////////////////////////////////////////////////////////////////
+*//////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+#include "TH1.h"
+#include "TH1D.h"
+#include "TAxis.h"
+#include "TArrayD.h"
+
+
+class AqgcMorphing {
+public:
+
+  enum Errors { kSqrtErrors, kUniformErrors };
+
+  explicit AqgcMorphing(int degree = 2, Errors errors = kSqrtErrors) :
+    degree_(degree), errors_(errors), twoD_(false), nBins_(0), binning_(0) {}
+
+  /// ratio = 0 stands for the SM point (ratio 1 in every bin)
+  void addPoint(double x, const TH1 * ratio) { add(x, 0., ratio); }
+  void addPoint(double x, double y, const TH1 * ratio) { twoD_ = true; add(x, y, ratio); }
+  void addSMPoint() { add(0., 0., 0); }
+
+  int nTerms() const { return twoD_ ? (degree_+1)*(degree_+2)/2 : degree_+1; }
+  int nBins() const { return nBins_; }
+
+  /// Fit all bins; false if any bin had too few points (its terms are 0)
+  bool fit() {
+    const int nT = nTerms(), nP = points_.size();
+    coef_.assign(nBins_*nT, 0.);
+    if (nBins_ == 0) {
+      std::cout << "AqgcMorphing: no ratio histogram given" << std::endl;
+      return false;
+    }
+
+    // basis functions at each point, in rescaled couplings
+    scaleX_ = scaleY_ = 0.;
+    for (int ip = 0; ip < nP; ip++) {
+      scaleX_ = std::max(scaleX_, std::fabs(points_[ip].x));
+      scaleY_ = std::max(scaleY_, std::fabs(points_[ip].y));
+    }
+    if (scaleX_ == 0.) scaleX_ = 1.;
+    if (scaleY_ == 0.) scaleY_ = 1.;
+    std::vector<double> basis(nP*nT);
+    for (int ip = 0; ip < nP; ip++)
+      fillBasis(points_[ip].x/scaleX_, points_[ip].y/scaleY_, &basis[ip*nT]);
+
+    std::vector<double> y(nP), w(nP), a(nT*nT), b(nT);
+    bool ok = true;
+
+    if (errors_ == kUniformErrors) {
+      // (B^T B)^-1 B^T once, then one matrix-vector product per bin
+      std::vector<double> proj(nT*nP);
+      for (int ip = 0; ip < nP; ip++) w[ip] = 1.;
+      normalMatrix(basis, w, a);
+      for (int ip = 0; ip < nP; ip++) {
+	for (int t = 0; t < nT; t++) b[t] = basis[ip*nT+t];
+	std::vector<double> m(a);
+	if (!solve(m, b)) {
+	  std::cout << "AqgcMorphing: too few coupling points for " << nT << " terms" << std::endl;
+	  return false;
+	}
+	for (int t = 0; t < nT; t++) proj[t*nP+ip] = b[t];
+      }
+      for (int bin = 1; bin <= nBins_; bin++) {
+	ratios(bin, y);
+	for (int t = 0; t < nT; t++) {
+	  double c = 0.;
+	  for (int ip = 0; ip < nP; ip++) c += proj[t*nP+ip]*y[ip];
+	  coef_[(bin-1)*nT+t] = c;
+	}
+      }
+    }
+    else {
+      for (int bin = 1; bin <= nBins_; bin++) {
+	ratios(bin, y);
+	for (int ip = 0; ip < nP; ip++) w[ip] = (y[ip] != 0.) ? 1./std::fabs(y[ip]) : 0.;
+	normalMatrix(basis, w, a);
+	for (int t = 0; t < nT; t++) {
+	  b[t] = 0.;
+	  for (int ip = 0; ip < nP; ip++) b[t] += basis[ip*nT+t]*w[ip]*y[ip];
+	}
+	if (!solve(a, b)) {
+	  std::cout << "AqgcMorphing: too few non-empty points in bin " << bin << std::endl;
+	  ok = false;
+	  continue;
+	}
+	for (int t = 0; t < nT; t++) coef_[(bin-1)*nT+t] = b[t];
+      }
+    }
+
+    // back to the original coupling units
+    std::vector<double> unit(nT);
+    fillBasis(1./scaleX_, 1./scaleY_, &unit[0]);
+    for (int bin = 0; bin < nBins_; bin++)
+      for (int t = 0; t < nT; t++) coef_[bin*nT+t] *= unit[t];
+    return ok;
+  }
+
+  /// coefficient of the given term in bin 1 ... nBins()
+  double coefficient(int term, int bin) const { return coef_[(bin-1)*nTerms()+term]; }
+
+  /// parameterised ratio to the SM in a bin
+  double ratio(int bin, double x, double y = 0.) const {
+    const int nT = nTerms();
+    std::vector<double> f(nT);
+    fillBasis(x, y, &f[0]);
+    double r = 0.;
+    for (int t = 0; t < nT; t++) r += coefficient(t, bin)*f[t];
+    return r;
+  }
+
+  /// histogram of one coefficient, with the binning of the ratios; null before fit()
+  TH1D * parameterHist(int term, const char * name, const char * title) const {
+    TH1D * h = emptyHist(name, title);
+    if (!h) return 0;
+    for (int bin = 1; bin <= nBins_; bin++) h->SetBinContent(bin, coefficient(term, bin));
+    return h;
+  }
+
+  /// parameterised ratio to the SM at a new coupling point; null before fit()
+  TH1D * ratioHist(const char * name, const char * title, double x, double y = 0.) const {
+    TH1D * h = emptyHist(name, title);
+    if (!h) return 0;
+    for (int bin = 1; bin <= nBins_; bin++) h->SetBinContent(bin, ratio(bin, x, y));
+    return h;
+  }
+
+private:
+
+  struct Point {
+    double x, y;
+    const TH1 * ratio;
+  };
+
+  void add(double x, double y, const TH1 * ratio) {
+    Point p = { x, y, ratio };
+    points_.push_back(p);
+    if (ratio && !binning_) {
+      binning_ = ratio;
+      nBins_ = ratio->GetNbinsX();
+    }
+  }
+
+  /// monomials ordered by total degree, then by decreasing power of x
+  void fillBasis(double x, double y, double * f) const {
+    int t = 0;
+    for (int d = 0; d <= degree_; d++) {
+      if (!twoD_) {
+	f[t++] = std::pow(x, d);
+	continue;
+      }
+      for (int py = 0; py <= d; py++) f[t++] = std::pow(x, d-py)*std::pow(y, py);
+    }
+  }
+
+  void ratios(int bin, std::vector<double> & y) const {
+    for (unsigned int ip = 0; ip < points_.size(); ip++)
+      y[ip] = points_[ip].ratio ? points_[ip].ratio->GetBinContent(bin) : 1.;
+  }
+
+  void normalMatrix(const std::vector<double> & basis, const std::vector<double> & w,
+		    std::vector<double> & a) const {
+    const int nT = nTerms(), nP = points_.size();
+    for (int i = 0; i < nT; i++)
+      for (int j = 0; j < nT; j++) {
+	double s = 0.;
+	for (int ip = 0; ip < nP; ip++) s += basis[ip*nT+i]*w[ip]*basis[ip*nT+j];
+	a[i*nT+j] = s;
+      }
+  }
+
+  /// Gaussian elimination with partial pivoting; a is destroyed, b becomes x
+  bool solve(std::vector<double> & a, std::vector<double> & b) const {
+    const int n = b.size();
+    double norm = 0.;
+    for (int i = 0; i < n*n; i++) norm = std::max(norm, std::fabs(a[i]));
+    for (int col = 0; col < n; col++) {
+      int piv = col;
+      for (int row = col+1; row < n; row++)
+	if (std::fabs(a[row*n+col]) > std::fabs(a[piv*n+col])) piv = row;
+      if (std::fabs(a[piv*n+col]) <= 1e-12*norm) return false;
+      if (piv != col) {
+	for (int k = 0; k < n; k++) std::swap(a[col*n+k], a[piv*n+k]);
+	std::swap(b[col], b[piv]);
+      }
+      for (int row = col+1; row < n; row++) {
+	const double f = a[row*n+col]/a[col*n+col];
+	for (int k = col; k < n; k++) a[row*n+k] -= f*a[col*n+k];
+	b[row] -= f*b[col];
+      }
+    }
+    for (int row = n-1; row >= 0; row--) {
+      for (int k = row+1; k < n; k++) b[row] -= a[row*n+k]*b[k];
+      b[row] /= a[row*n+row];
+    }
+    return true;
+  }
+
+  TH1D * emptyHist(const char * name, const char * title) const {
+    if (!binning_ || (int) coef_.size() != nBins_*nTerms()) {
+      std::cout << "AqgcMorphing: no fitted ratio histograms, " << name << " not booked" << std::endl;
+      return 0;
+    }
+    const TAxis * axis = binning_->GetXaxis();
+    if (axis->GetXbins()->GetSize())
+      return new TH1D(name, title, nBins_, axis->GetXbins()->GetArray());
+    return new TH1D(name, title, nBins_, axis->GetXmin(), axis->GetXmax());
+  }
+
+  int degree_;
+  Errors errors_;
+  bool twoD_;
+  int nBins_;
+  const TH1 * binning_;
+  double scaleX_, scaleY_;
+  std::vector<Point> points_;
+  std::vector<double> coef_;
+};
+
+#endif
@@ -19,6 +19,8 @@ class kanaelec {
 public :
    TTree          *fChain;   //!pointer to the analyzed TTree or TChain
    Int_t           fCurrent; //!current Tree number in a TChain
+   Int_t           fPart;    //!this job reduces entry range fPart of fNParts
+   Int_t           fNParts;  //!number of jobs the input is split into
 
    // Declaration of leaf types
    Int_t           numPFCorJets;
@@ -2005,7 +2007,7 @@ public :
    virtual Bool_t   Notify();
    virtual void     Show(Long64_t entry = -1);
 
-   virtual void     myana(double myflag = -999, bool isQCD = false, int runflag=0);
+   virtual void     myana(double myflag = -999, bool isQCD = false, int runflag=0, int part=0, int nParts=1);
    virtual void     Loop(TH1F* h_events, 
                          TH1F* h_events_weighted,
                          int wda, 
@@ -2060,6 +2062,7 @@ kanaelec::kanaelec(TTree *tree)
       tree = (TTree*)gDirectory->Get("WJet");
 
    }
+   fPart = 0; fNParts = 1;
    Init(tree);
 }
 